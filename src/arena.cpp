@@ -0,0 +1,261 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <new>
+#include <atomic>
+#include <vector>
+#include "arena.h"
+#include "crypt.h"
+#include "cryptopp/misc.h"
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace nppcrypt
+{
+namespace arena
+{
+namespace
+{
+    /* in front of every block, keeps the payload 16 byte aligned */
+    const size_t header_size = 16;
+    /* payload of size class 0, every further class doubles it */
+    const size_t class_min = 16;
+    const size_t classes = 9;
+
+    static_assert((class_min << (classes - 1)) == Constants::arena_class_max, "arena: size classes do not end at arena_class_max");
+
+    struct Arena;
+
+    struct Block
+    {
+        /* NULL: a large block with pages of its own */
+        Arena*  owner;
+        /* size class, the number of mapped bytes of large blocks */
+        size_t  size;
+    };
+
+    size_t queryPageSize()
+    {
+#ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwPageSize;
+#else
+        return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+    }
+
+    size_t pageSize()
+    {
+        static const size_t size = queryPageSize();
+        return size;
+    }
+
+    /* length bytes of zeroed pages, locked and excluded from core dumps if the os allows it */
+    void* mapPages(size_t length)
+    {
+#ifdef _WIN32
+        void* p = VirtualAlloc(NULL, length, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        VirtualLock(p, length);
+#else
+        void* p = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        mlock(p, length);
+#ifdef MADV_DONTDUMP
+        madvise(p, length, MADV_DONTDUMP);
+#endif
+#endif
+        return p;
+    }
+
+    void unmapPages(void* p, size_t length)
+    {
+#ifdef _WIN32
+        VirtualUnlock(p, length);
+        VirtualFree(p, 0, MEM_RELEASE);
+#else
+        munlock(p, length);
+        munmap(p, length);
+#endif
+    }
+
+    struct Arena
+    {
+        /* the thread holds one reference */
+        Arena() : next(NULL), left(0), remote(NULL), live(1)
+        {
+            for (size_t i = 0; i < classes; i++) {
+                free_blocks[i] = NULL;
+            }
+        };
+
+        ~Arena()
+        {
+            for (size_t i = 0; i < chunks.size(); i++) {
+                unmapPages(chunks[i], Constants::arena_chunk);
+            }
+        };
+
+        /* owner thread: payload of a block of size class c */
+        void* take(size_t c)
+        {
+            if (!free_blocks[c] && remote.load(std::memory_order_relaxed)) {
+                collect();
+            }
+            void* p = free_blocks[c];
+            if (p) {
+                free_blocks[c] = *(void**)p;
+            } else {
+                size_t length = header_size + (class_min << c);
+                if (left < length) {
+                    chunks.reserve(chunks.size() + 1);
+                    next = (unsigned char*)mapPages(Constants::arena_chunk);
+                    chunks.push_back(next);
+                    left = Constants::arena_chunk;
+                }
+                Block* b = (Block*)next;
+                b->owner = this;
+                b->size = c;
+                p = next + header_size;
+                next += length;
+                left -= length;
+            }
+            live.fetch_add(1, std::memory_order_relaxed);
+            return p;
+        };
+
+        /* owner thread */
+        void give(void* p, size_t c)
+        {
+            *(void**)p = free_blocks[c];
+            free_blocks[c] = p;
+        };
+
+        /* any other thread */
+        void giveRemote(void* p)
+        {
+            void* head = remote.load(std::memory_order_relaxed);
+            do {
+                *(void**)p = head;
+            } while (!remote.compare_exchange_weak(head, p, std::memory_order_release, std::memory_order_relaxed));
+        };
+
+        /* owner thread: moves the blocks released by other threads to the free lists */
+        void collect()
+        {
+            void* p = remote.exchange(NULL, std::memory_order_acquire);
+            while (p) {
+                void* n = *(void**)p;
+                give(p, ((Block*)((unsigned char*)p - header_size))->size);
+                p = n;
+            }
+        };
+
+        /* true if it was the last reference: the arena has to be deleted */
+        bool unref()
+        {
+            return live.fetch_sub(1, std::memory_order_acq_rel) == 1;
+        };
+
+        std::vector<void*>  chunks;
+        /* the unused rest of the last chunk */
+        unsigned char*      next;
+        size_t              left;
+        /* free blocks of every size class, linked through their first word */
+        void*               free_blocks[classes];
+        /* blocks released by other threads */
+        std::atomic<void*>  remote;
+        /* blocks handed out and not released yet, plus one while the thread is running */
+        std::atomic<size_t> live;
+    };
+
+    /* the arena of the calling thread, created on its first allocation */
+    struct Current
+    {
+        Current() : arena(NULL) {};
+        ~Current()
+        {
+            /* blocks released later go back through the remote list, the last one deletes the arena */
+            Arena* a = arena;
+            arena = NULL;
+            if (a && a->unref()) {
+                delete a;
+            }
+        };
+
+        Arena* arena;
+    };
+
+    thread_local Current current;
+
+    size_t sizeClass(size_t size)
+    {
+        size_t c = 0;
+        while ((class_min << c) < size) {
+            c++;
+        }
+        return c;
+    }
+}
+
+void* allocate(size_t size)
+{
+    if (size > Constants::arena_class_max) {
+        size_t page = pageSize();
+        size_t length = (header_size + size + page - 1) / page * page;
+        Block* b = (Block*)mapPages(length);
+        b->owner = NULL;
+        b->size = length;
+        return (unsigned char*)b + header_size;
+    }
+    if (!current.arena) {
+        current.arena = new Arena();
+    }
+    return current.arena->take(sizeClass(size));
+}
+
+void release(void* p, size_t size)
+{
+    if (!p) {
+        return;
+    }
+    CryptoPP::SecureWipeBuffer((unsigned char*)p, size);
+    Block* b = (Block*)((unsigned char*)p - header_size);
+    Arena* a = b->owner;
+    if (!a) {
+        unmapPages(b, b->size);
+        return;
+    }
+    if (a == current.arena) {
+        a->give(p, b->size);
+    } else {
+        a->giveRemote(p);
+    }
+    if (a->unref()) {
+        delete a;
+    }
+}
+
+};
+};
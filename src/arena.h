@@ -0,0 +1,71 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef ARENA_H_DEF
+#define ARENA_H_DEF
+
+#include <cstddef>
+#include "cryptopp/secblock.h"
+
+/* memory of keys, passwords and sensitive scratch buffers: every thread takes blocks from an arena of its own, carved out of
+   chunks of pages that are locked in ram (mlock/VirtualLock) and excluded from core dumps (MADV_DONTDUMP where available).
+   Locking is best effort: beyond the memlock limit the pages are used unlocked.
+   Blocks up to Constants::arena_class_max bytes come from power of two size classes and are reused, larger ones get pages of their own.
+   A block is wiped once when it is released. Any thread may release it: its own thread reuses it without locks, other threads
+   hand it back through an atomic list. The arena of a thread lives until the thread has exited and the last of its blocks is released. */
+namespace nppcrypt
+{
+    namespace arena
+    {
+        /* size bytes, not initialized. Throws std::bad_alloc */
+        void*   allocate(size_t size);
+        /* wipes size bytes at p (the size passed to allocate()) and returns the block to its arena */
+        void    release(void* p, size_t size);
+
+        /* the allocator of secure_string and secure_block ( see crypt.h ) */
+        template<class T> class Allocator : public CryptoPP::AllocatorBase<T>
+        {
+        public:
+            typedef typename CryptoPP::AllocatorBase<T>::size_type  size_type;
+            typedef typename CryptoPP::AllocatorBase<T>::pointer    pointer;
+
+            Allocator() {};
+            template<class V> Allocator(const Allocator<V>&) {};
+
+            pointer allocate(size_type size, const void* = NULL)
+            {
+                this->CheckSize(size);
+                return size ? static_cast<pointer>(arena::allocate(size * sizeof(T))) : NULL;
+            };
+            void deallocate(void* p, size_type size)
+            {
+                if (p) {
+                    arena::release(p, size * sizeof(T));
+                }
+            };
+            pointer reallocate(T* p, size_type old_size, size_type new_size, bool preserve)
+            {
+                return CryptoPP::StandardReallocate(*this, p, old_size, new_size, preserve);
+            };
+
+            template<class V> struct rebind { typedef Allocator<V> other; };
+        };
+
+        template<class T, class V> bool operator == (const Allocator<T>&, const Allocator<V>&) { return true; };
+        template<class T, class V> bool operator != (const Allocator<T>&, const Allocator<V>&) { return false; };
+    };
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include "checksum.h"
+#include "cryptopp/cpu.h"
+
+using namespace nppcrypt;
+using CryptoPP::word32;
+
+namespace
+{
+    const word32 ADLER_BASE = 65521;
+    /* largest n such that 255n(n+1)/2 + (n+1)(BASE-1) <= 2^32-1 */
+    const size_t ADLER_NMAX = 5552;
+    const word32 CRC32_POLY = 0xEDB88320;
+    const word32 CRC32C_POLY = 0x82F63B78;
+
+    struct CrcTable
+    {
+        CrcTable(word32 poly)
+        {
+            for (word32 n = 0; n < 256; n++) {
+                word32 c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? (poly ^ (c >> 1)) : (c >> 1);
+                }
+                t[n] = c;
+            }
+        }
+        word32 t[256];
+    };
+
+    word32 adler32(word32 adler, const byte* data, size_t length)
+    {
+        size_t blocks = length & ~(size_t)31;
+        if (blocks) {
+#if (CRYPTOPP_AVX2_AVAILABLE)
+            if (CryptoPP::HasAVX2()) {
+                adler = simd::adler32_avx2(adler, data, blocks);
+                data += blocks;
+                length -= blocks;
+            } else
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+            if (CryptoPP::HasSSSE3()) {
+                adler = simd::adler32_ssse3(adler, data, blocks);
+                data += blocks;
+                length -= blocks;
+            }
+#endif
+        }
+        word32 s1 = adler & 0xffff;
+        word32 s2 = adler >> 16;
+        while (length) {
+            size_t n = (length < ADLER_NMAX) ? length : ADLER_NMAX;
+            length -= n;
+            for (; n; n--, data++) {
+                s1 += *data;
+                s2 += s1;
+            }
+            s1 %= ADLER_BASE;
+            s2 %= ADLER_BASE;
+        }
+        return (s2 << 16) | s1;
+    }
+
+    word32 crcTable(const CrcTable& table, word32 crc, const byte* data, size_t length)
+    {
+        for (; length; length--, data++) {
+            crc = table.t[(crc ^ *data) & 0xff] ^ (crc >> 8);
+        }
+        return crc;
+    }
+
+    word32 crc32(word32 crc, const byte* data, size_t length)
+    {
+        static const CrcTable table(CRC32_POLY);
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+        if (length >= 64 && Checksum::accelerated(Checksum::Type::crc32)) {
+            size_t blocks = length & ~(size_t)15;
+            crc = simd::crc32_clmul(crc, data, blocks);
+            data += blocks;
+            length -= blocks;
+        }
+#endif
+        return crcTable(table, crc, data, length);
+    }
+
+    word32 crc32c(word32 crc, const byte* data, size_t length)
+    {
+#if (CRYPTOPP_SSE42_AVAILABLE)
+        if (Checksum::accelerated(Checksum::Type::crc32c)) {
+            return simd::crc32c_sse42(crc, data, length);
+        }
+#endif
+        static const CrcTable table(CRC32C_POLY);
+        return crcTable(table, crc, data, length);
+    }
+}
+
+nppcrypt::Checksum::Checksum(Type t) : type(t)
+{
+    Restart();
+}
+
+bool nppcrypt::Checksum::accelerated(Type t)
+{
+    switch (t) {
+    case Type::adler32:
+#if (CRYPTOPP_AVX2_AVAILABLE)
+        if (CryptoPP::HasAVX2()) {
+            return true;
+        }
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+        return CryptoPP::HasSSSE3();
+#else
+        return false;
+#endif
+    case Type::crc32:
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+        return CryptoPP::HasCLMUL() && CryptoPP::HasSSE41();
+#else
+        return false;
+#endif
+    case Type::crc32c:
+#if (CRYPTOPP_SSE42_AVAILABLE)
+        return CryptoPP::HasSSE42();
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+std::string nppcrypt::Checksum::AlgorithmName() const
+{
+    switch (type) {
+    case Type::adler32: return "Adler32";
+    case Type::crc32c: return "CRC32C";
+    default: return "CRC32";
+    }
+}
+
+void nppcrypt::Checksum::Restart()
+{
+    state = (type == Type::adler32) ? 1 : 0xFFFFFFFF;
+}
+
+void nppcrypt::Checksum::Update(const byte* input, size_t length)
+{
+    if (!length) {
+        return;
+    }
+    switch (type) {
+    case Type::adler32: state = adler32(state, input, length); break;
+    case Type::crc32: state = crc32(state, input, length); break;
+    case Type::crc32c: state = crc32c(state, input, length); break;
+    }
+}
+
+void nppcrypt::Checksum::TruncatedFinal(byte* hash, size_t size)
+{
+    ThrowIfInvalidTruncatedSize(size);
+
+    /* byte order of cryptopp: adler32 big endian (s2, s1), crc little endian */
+    if (type == Type::adler32) {
+        for (size_t i = 0; i < size; i++) {
+            hash[i] = (byte)(state >> (24 - 8 * i));
+        }
+    } else {
+        word32 crc = state ^ 0xFFFFFFFF;
+        for (size_t i = 0; i < size; i++) {
+            hash[i] = (byte)(crc >> (8 * i));
+        }
+    }
+    Restart();
+}
@@ -0,0 +1,59 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef CHECKSUM_H_DEF
+#define CHECKSUM_H_DEF
+
+#include "crypt.h"
+#include "cryptopp/cryptlib.h"
+
+namespace nppcrypt
+{
+    /* non-cryptographic checksums with runtime selected simd kernels (see checksum_simd.cpp, checksum_avx2.cpp),
+       output is identical to cryptopp's Adler32/CRC32/CRC32C */
+    class Checksum : public CryptoPP::HashTransformation
+    {
+    public:
+        enum class Type : unsigned {
+            adler32, crc32, crc32c
+        };
+
+        Checksum(Type t);
+
+        /* true if the cpu supports the simd kernel of t */
+        static bool  accelerated(Type t);
+
+        std::string  AlgorithmName() const;
+        unsigned int DigestSize() const { return 4; };
+        void         Update(const byte* input, size_t length);
+        void         TruncatedFinal(byte* hash, size_t size);
+        void         Restart();
+
+    private:
+        Type                type;
+        CryptoPP::word32    state;
+    };
+
+    namespace simd
+    {
+        /* adler: (s2 << 16) | s1, length must be a multiple of 32 */
+        CryptoPP::word32 adler32_ssse3(CryptoPP::word32 adler, const byte* data, size_t length);
+        CryptoPP::word32 adler32_avx2(CryptoPP::word32 adler, const byte* data, size_t length);
+        CryptoPP::word32 crc32_clmul(CryptoPP::word32 crc, const byte* data, size_t length);
+        CryptoPP::word32 crc32c_sse42(CryptoPP::word32 crc, const byte* data, size_t length);
+    };
+};
+
+#endif
@@ -0,0 +1,79 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* AVX2 checksum kernels, needs -mavx2 with gcc/clang (see GNUmakefile) */
+
+#include "checksum.h"
+#include "cryptopp/config.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <immintrin.h>
+#endif
+
+using CryptoPP::word32;
+
+namespace nppcrypt
+{
+namespace simd
+{
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+/* Adler-32, same scheme as adler32_ssse3() but with one 32 byte block per ymm register */
+word32 adler32_avx2(word32 adler, const byte* data, size_t length)
+{
+    const word32 BASE = 65521;
+    const size_t NMAX_BLOCKS = 5552 / 32;
+
+    word32 s1 = adler & 0xffff;
+    word32 s2 = adler >> 16;
+    size_t blocks = length / 32;
+
+    const __m256i tap = _mm256_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17,
+                                         16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    while (blocks) {
+        size_t n = (blocks < NMAX_BLOCKS) ? blocks : NMAX_BLOCKS;
+        blocks -= n;
+
+        __m256i v_ps = _mm256_setr_epi32((int)(s1 * n), 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s2 = _mm256_setr_epi32((int)s2, 0, 0, 0, 0, 0, 0, 0);
+        __m256i v_s1 = _mm256_setzero_si256();
+
+        for (; n; n--, data += 32) {
+            const __m256i bytes = _mm256_loadu_si256((const __m256i*)data);
+            v_ps = _mm256_add_epi32(v_ps, v_s1);
+            v_s1 = _mm256_add_epi32(v_s1, _mm256_sad_epu8(bytes, zero));
+            v_s2 = _mm256_add_epi32(v_s2, _mm256_madd_epi16(_mm256_maddubs_epi16(bytes, tap), ones));
+        }
+        v_s2 = _mm256_add_epi32(v_s2, _mm256_slli_epi32(v_ps, 5));
+
+        __m128i h_s1 = _mm_add_epi32(_mm256_castsi256_si128(v_s1), _mm256_extracti128_si256(v_s1, 1));
+        __m128i h_s2 = _mm_add_epi32(_mm256_castsi256_si128(v_s2), _mm256_extracti128_si256(v_s2, 1));
+        h_s1 = _mm_add_epi32(h_s1, _mm_shuffle_epi32(h_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+        h_s1 = _mm_add_epi32(h_s1, _mm_shuffle_epi32(h_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+        h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        h_s2 = _mm_add_epi32(h_s2, _mm_shuffle_epi32(h_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 = (s1 + (word32)_mm_cvtsi128_si32(h_s1)) % BASE;
+        s2 = (word32)_mm_cvtsi128_si32(h_s2) % BASE;
+    }
+    _mm256_zeroupper();
+    return (s2 << 16) | s1;
+}
+#endif
+
+};
+};
@@ -0,0 +1,289 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* SSSE3/SSE4.2/CLMUL checksum kernels, needs -msse4.2 -mpclmul with gcc/clang (see GNUmakefile) */
+
+#include <cstring>
+#include "checksum.h"
+#include "cryptopp/config.h"
+
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+# include <tmmintrin.h>
+#endif
+#if (CRYPTOPP_SSE42_AVAILABLE)
+# include <nmmintrin.h>
+#endif
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+# include <wmmintrin.h>
+#endif
+
+using CryptoPP::word32;
+using CryptoPP::word64;
+
+namespace nppcrypt
+{
+namespace simd
+{
+
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+/* Adler-32 over 32 byte blocks: s1 with psadbw, s2 as dot product of the bytes with the weights 32..1 (pmaddubsw).
+   s1 * 32 of every block is added to s2 by the deferred v_ps sum, the modulo is only applied every
+   NMAX (5552) bytes, the largest n for which 255n(n+1)/2 + (n+1)(BASE-1) fits 32 bit. */
+word32 adler32_ssse3(word32 adler, const byte* data, size_t length)
+{
+    const word32 BASE = 65521;
+    const size_t NMAX_BLOCKS = 5552 / 32;
+
+    word32 s1 = adler & 0xffff;
+    word32 s2 = adler >> 16;
+    size_t blocks = length / 32;
+
+    const __m128i tap1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+    const __m128i tap2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi16(1);
+
+    while (blocks) {
+        size_t n = (blocks < NMAX_BLOCKS) ? blocks : NMAX_BLOCKS;
+        blocks -= n;
+
+        __m128i v_ps = _mm_setr_epi32((int)(s1 * n), 0, 0, 0);
+        __m128i v_s2 = _mm_setr_epi32((int)s2, 0, 0, 0);
+        __m128i v_s1 = _mm_setzero_si128();
+
+        for (; n; n--, data += 32) {
+            const __m128i bytes1 = _mm_loadu_si128((const __m128i*)data);
+            const __m128i bytes2 = _mm_loadu_si128((const __m128i*)(data + 16));
+            v_ps = _mm_add_epi32(v_ps, v_s1);
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes1, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, tap1), ones));
+            v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(bytes2, zero));
+            v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, tap2), ones));
+        }
+        v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1, 0, 3, 2)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2, 3, 0, 1)));
+        v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1, 0, 3, 2)));
+        s1 = (s1 + (word32)_mm_cvtsi128_si32(v_s1)) % BASE;
+        s2 = (word32)_mm_cvtsi128_si32(v_s2) % BASE;
+    }
+    return (s2 << 16) | s1;
+}
+#endif
+
+#if (CRYPTOPP_CLMUL_AVAILABLE)
+/* CRC-32 (0xEDB88320) by folding 4x128 bit with carry-less multiplication, followed by a barrett reduction.
+   Constants and algorithm: Gopal et al., "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ
+   Instruction", Intel 2009. length must be >= 64 and a multiple of 16. */
+word32 crc32_clmul(word32 crc, const byte* data, size_t length)
+{
+    CRYPTOPP_ALIGN_DATA(16) static const word64 k1k2[2] = { 0x0154442bd4, 0x01c6e41596 };
+    CRYPTOPP_ALIGN_DATA(16) static const word64 k3k4[2] = { 0x01751997d0, 0x00ccaa009e };
+    CRYPTOPP_ALIGN_DATA(16) static const word64 k5k0[2] = { 0x0163cd6124, 0x0000000000 };
+    CRYPTOPP_ALIGN_DATA(16) static const word64 poly[2] = { 0x01db710641, 0x01f7011641 };
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8;
+
+    x1 = _mm_loadu_si128((const __m128i*)(data + 0x00));
+    x2 = _mm_loadu_si128((const __m128i*)(data + 0x10));
+    x3 = _mm_loadu_si128((const __m128i*)(data + 0x20));
+    x4 = _mm_loadu_si128((const __m128i*)(data + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128((int)crc));
+    x0 = _mm_load_si128((const __m128i*)k1k2);
+    data += 64;
+    length -= 64;
+
+    /* fold 4 x 128 bit in parallel */
+    for (; length >= 64; data += 64, length -= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128((const __m128i*)(data + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128((const __m128i*)(data + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128((const __m128i*)(data + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128((const __m128i*)(data + 0x30)));
+    }
+
+    /* fold into 128 bit */
+    x0 = _mm_load_si128((const __m128i*)k3k4);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x3), x5);
+    x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+    x1 = _mm_xor_si128(_mm_xor_si128(x1, x4), x5);
+
+    /* remaining 16 byte blocks */
+    for (; length >= 16; data += 16, length -= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128((const __m128i*)data)), x5);
+    }
+
+    /* fold 128 to 64 bit */
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64((const __m128i*)k5k0);
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    /* barrett reduction to 32 bit */
+    x0 = _mm_load_si128((const __m128i*)poly);
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return (word32)_mm_extract_epi32(x1, 1);
+}
+#endif
+
+#if (CRYPTOPP_SSE42_AVAILABLE)
+namespace
+{
+    /* crc32 has a latency of 3 cycles but a throughput of 1 per cycle: three independent streams of
+       LONG (or SHORT) bytes are computed at once and combined with the zeros operator
+       (Mark Adler, crc32c.c, 2013) */
+    const size_t LONG = 8192;
+    const size_t SHORT = 256;
+    const word32 POLY = 0x82f63b78;
+
+    word32 gf2_matrix_times(const word32* mat, word32 vec)
+    {
+        word32 sum = 0;
+        for (; vec; vec >>= 1, mat++) {
+            if (vec & 1) {
+                sum ^= *mat;
+            }
+        }
+        return sum;
+    }
+
+    void gf2_matrix_square(word32* square, const word32* mat)
+    {
+        for (int n = 0; n < 32; n++) {
+            square[n] = gf2_matrix_times(mat, mat[n]);
+        }
+    }
+
+    /* byte-wise tables that apply len (power of two) zero bytes to a crc */
+    struct ZerosTable
+    {
+        ZerosTable(size_t len)
+        {
+            word32 even[32], odd[32];
+            odd[0] = POLY;
+            for (int n = 1; n < 32; n++) {
+                odd[n] = (word32)1 << (n - 1);
+            }
+            gf2_matrix_square(even, odd);
+            gf2_matrix_square(odd, even);
+            const word32* op = even;
+            for (;;) {
+                gf2_matrix_square(even, odd);
+                op = even;
+                len >>= 1;
+                if (!len) {
+                    break;
+                }
+                gf2_matrix_square(odd, even);
+                op = odd;
+                len >>= 1;
+                if (!len) {
+                    break;
+                }
+            }
+            for (word32 n = 0; n < 256; n++) {
+                t[0][n] = gf2_matrix_times(op, n);
+                t[1][n] = gf2_matrix_times(op, n << 8);
+                t[2][n] = gf2_matrix_times(op, n << 16);
+                t[3][n] = gf2_matrix_times(op, n << 24);
+            }
+        }
+        word32 shift(word32 crc) const
+        {
+            return t[0][crc & 0xff] ^ t[1][(crc >> 8) & 0xff] ^ t[2][(crc >> 16) & 0xff] ^ t[3][crc >> 24];
+        }
+        word32 t[4][256];
+    };
+
+    inline word64 crc32c_u64(word64 crc, const byte* p)
+    {
+        word64 v;
+        std::memcpy(&v, p, 8);
+#if CRYPTOPP_BOOL_X64
+        return _mm_crc32_u64(crc, v);
+#else
+        crc = _mm_crc32_u32((word32)crc, (word32)v);
+        return _mm_crc32_u32((word32)crc, (word32)(v >> 32));
+#endif
+    }
+
+    inline const byte* crc32c_3way(word64& crc0, const byte* data, size_t block, const ZerosTable& zeros)
+    {
+        word64 crc1 = 0, crc2 = 0;
+        const byte* end = data + block;
+        for (; data < end; data += 8) {
+            crc0 = crc32c_u64(crc0, data);
+            crc1 = crc32c_u64(crc1, data + block);
+            crc2 = crc32c_u64(crc2, data + 2 * block);
+        }
+        crc0 = zeros.shift((word32)crc0) ^ crc1;
+        crc0 = zeros.shift((word32)crc0) ^ crc2;
+        return data + 2 * block;
+    }
+}
+
+/* CRC-32C (Castagnoli) with the SSE4.2 crc32 instruction */
+word32 crc32c_sse42(word32 crc, const byte* data, size_t length)
+{
+    static const ZerosTable zeros_long(LONG);
+    static const ZerosTable zeros_short(SHORT);
+    word64 crc0 = crc;
+
+    for (; length >= 3 * LONG; length -= 3 * LONG) {
+        data = crc32c_3way(crc0, data, LONG, zeros_long);
+    }
+    for (; length >= 3 * SHORT; length -= 3 * SHORT) {
+        data = crc32c_3way(crc0, data, SHORT, zeros_short);
+    }
+    for (; length >= 8; length -= 8, data += 8) {
+        crc0 = crc32c_u64(crc0, data);
+    }
+    word32 c = (word32)crc0;
+    for (; length; length--, data++) {
+        c = _mm_crc32_u8(c, *data);
+    }
+    return c;
+}
+#endif
+
+};
+};
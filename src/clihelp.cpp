@@ -14,14 +14,27 @@ GNU General Public License for more details.
 */
 
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <iostream>
+#include <fstream>
 #include <clocale>
 #include "clihelp.h"
 #ifdef _WIN32
 #include <windows.h>
+#include <io.h>
+#include <fcntl.h>
 #else
 #undef __USE_CRYPT
 #include <termios.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include <climits>
+#include <cerrno>
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
 #define STDIN_FILENO 0
 #define STDOUT_FILENO 1
 #define STDErR_FILENO 2
@@ -108,4 +121,84 @@ void readLine(nppcrypt::secure_string& out)
 #else
     std::getline(std::cin, out);
 #endif
-}
\ No newline at end of file
+}
+
+void setBinaryIO()
+{
+#ifdef WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+}
+
+bool writeSegments(const std::string& path, const char* header, size_t header_length, const nppcrypt::SegmentedBuffer& data)
+{
+#ifdef WIN32
+    std::ofstream fs;
+    std::ostream* out = &std::cout;
+    if (path.size()) {
+        fs.open(path, std::ios::out | std::ios::binary);
+        if (!fs.is_open()) {
+            return false;
+        }
+        out = &fs;
+    }
+    if (header && header_length) {
+        out->write(header, header_length);
+    }
+    for (size_t i = 0; i < data.segments(); i++) {
+        out->write((const char*)data.segment(i), data.segmentSize(i));
+    }
+    out->flush();
+    return out->good();
+#else
+    std::vector<iovec> parts;
+    parts.reserve(data.segments() + 1);
+    if (header && header_length) {
+        iovec part = { (void*)header, header_length };
+        parts.push_back(part);
+    }
+    for (size_t i = 0; i < data.segments(); i++) {
+        if (data.segmentSize(i)) {
+            iovec part = { (void*)data.segment(i), data.segmentSize(i) };
+            parts.push_back(part);
+        }
+    }
+
+    int fd = STDOUT_FILENO;
+    if (path.size()) {
+        fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0) {
+            return false;
+        }
+    } else {
+        std::cout.flush();
+    }
+    /* up to IOV_MAX segments per call, partial writes continue inside the segment */
+    bool ok = true;
+    size_t i = 0;
+    while (i < parts.size()) {
+        ssize_t written = writev(fd, &parts[i], (int)std::min<size_t>(parts.size() - i, IOV_MAX));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ok = false;
+            break;
+        }
+        size_t n = (size_t)written;
+        while (i < parts.size() && n >= parts[i].iov_len) {
+            n -= parts[i].iov_len;
+            i++;
+        }
+        if (n) {
+            parts[i].iov_base = (char*)parts[i].iov_base + n;
+            parts[i].iov_len -= n;
+        }
+    }
+    if (path.size() && close(fd) != 0) {
+        ok = false;
+    }
+    return ok;
+#endif
+}
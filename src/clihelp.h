@@ -22,5 +22,9 @@ GNU General Public License for more details.
 void setEcho(bool enable = true);
 bool setLocale();
 void readLine(nppcrypt::secure_string& out);
+/* stdin/stdout without newline translation */
+void setBinaryIO();
+/* header followed by the segments of data to the file path (stdout if path is empty), with writev() where available. Returns false on errors */
+bool writeSegments(const std::string& path, const char* header, size_t header_length, const nppcrypt::SegmentedBuffer& data);
 
 #endif
@@ -18,6 +18,7 @@ GNU General Public License for more details.
 #include <iostream>
 #include <algorithm>
 #include <fstream>
+#include <sstream>
 #include <array>
 #include <vector>
 #include <sys/stat.h>
@@ -26,6 +27,7 @@ GNU General Public License for more details.
 #include <memory>
 #include "cli11/CLI11.hpp"
 #include "crypt.h"
+#include "codec.h"
 #include "crypt_help.h"
 #include "cryptheader.h"
 #include "exception.h"
@@ -41,6 +43,7 @@ struct Arguments
 {
     std::string action;
     std::string input;
+    std::vector<std::string> inputs;
     std::string output;
     std::string hash;
     std::string password;
@@ -53,11 +56,15 @@ struct Arguments
     std::string salt;
     std::string hmac;
     std::string hash_key;
+    std::string hash_custom;
+    std::string from;
+    std::vector<std::string> alphabets;
 };
 
 struct CLIOptions
 {
     CLI::Option* input;
+    CLI::Option* inputs;
     CLI::Option* output;
     CLI::Option* hash;
     CLI::Option* password;
@@ -70,6 +77,9 @@ struct CLIOptions
     CLI::Option* salt;
     CLI::Option* hmac;
     CLI::Option* hash_key;
+    CLI::Option* hash_custom;
+    CLI::Option* from;
+    CLI::Option* alphabets;
     CLI::Option* action;
     CLI::Option* noheader;
     CLI::Option* silent;
@@ -283,6 +293,8 @@ namespace help
             d.set(s + 7, len - 7, nppcrypt::Encoding::base32);
         } else if (cmpchars(s, len, "base64:", 7)) {
             d.set(s + 7, len - 7, nppcrypt::Encoding::base64);
+        } else if (cmpchars(s, len, "base85:", 7)) {
+            d.set(s + 7, len - 7, nppcrypt::Encoding::base85);
         } else if (cmpchars(s, len, "utf8:", 5)) {
             d.set(s, len, nppcrypt::Encoding::ascii);
         } else {
@@ -377,26 +389,26 @@ namespace check
     }
 
     /* -e --encoding, i.e. -e base16:unix:96:true [encoding:eol:linelength:uppercase] */
-    void encoding(nppcrypt::Options::Crypt& options)
+    void encoding(nppcrypt::Options::Crypt::Encoding& options)
     {
         if (opt.encoding->count()) {
             std::vector<size_t> pos;
             help::splitArgument(args.encoding, pos, ':');
-            if (!nppcrypt::help::getEncoding(args.encoding.c_str(), options.encoding.enc)) {
+            if (!nppcrypt::help::getEncoding(args.encoding.c_str(), options.enc)) {
                 throwInvalid(invalid_encoding);
             }
             if (pos.size() > 1) {
-                if (!nppcrypt::help::getEOL(&args.encoding[pos[1]], options.encoding.eol)) {
+                if (!nppcrypt::help::getEOL(&args.encoding[pos[1]], options.eol)) {
                     throwInvalid(invalid_eol);
                 }
                 if (pos.size() > 2) {
-                    options.encoding.linelength = std::atoi(&args.encoding[pos[2]]);
-                    options.encoding.linebreaks = (options.encoding.linelength == 0) ? false : true;
+                    options.linelength = std::atoi(&args.encoding[pos[2]]);
+                    options.linebreaks = (options.linelength == 0) ? false : true;
                     if (pos.size() > 3) {
                         if (strcmp(&args.encoding[pos[3]], "true") == 0) {
-                            options.encoding.uppercase = true;
+                            options.uppercase = true;
                         } else if (strcmp(&args.encoding[pos[3]], "false") == 0) {
-                            options.encoding.uppercase = false;
+                            options.uppercase = false;
                         } else {
                             throwInvalid(invalid_uppercase);
                         }
@@ -406,6 +418,64 @@ namespace check
         }
     }
 
+    /* convert: -f --from [source encoding], -e --encoding [target encoding, see above] */
+    void convert(nppcrypt::Options::Convert& options)
+    {
+        if (opt.from->count() && !nppcrypt::help::getEncoding(args.from.c_str(), options.from)) {
+            throwInvalid(invalid_encoding);
+        }
+        nppcrypt::Options::Crypt::Encoding target;
+        target.enc = options.to;
+        target.eol = options.eol;
+        target.linelength = options.linelength;
+        target.linebreaks = options.linebreaks;
+        target.uppercase = options.uppercase;
+        encoding(target);
+        options.to = target.enc;
+        options.eol = target.eol;
+        options.linelength = target.linelength;
+        options.linebreaks = target.linebreaks;
+        options.uppercase = target.uppercase;
+    }
+
+    /* --alphabet , the length selects the encoding: 32 (base32), 64 (base64) or 85 (base85) characters,
+       base32/base64 alphabets may be followed by the padding character, i.e. --alphabet ABCDEFGHIJKLMNOPQRSTUVWXYZ234567=
+       The base85 alphabets z85 and rfc1924 are selected by name */
+    void alphabets(nppcrypt::EncodingAlphabet* alphabets, const nppcrypt::EncodingAlphabet** custom)
+    {
+        for (const std::string& arg : args.alphabets) {
+            std::string a = arg;
+            if (a == "z85") {
+                a = nppcrypt::codec::base85_z85;
+            } else if (a == "rfc1924") {
+                a = nppcrypt::codec::base85_rfc1924;
+            }
+            size_t length = a.size();
+            nppcrypt::byte padding = 0;
+            if (length == 33 || length == 65) {
+                padding = (nppcrypt::byte)a.back();
+                length--;
+            }
+            int i = (length == 32) ? 0 : (length == 64) ? 1 : (length == 85) ? 2 : -1;
+            if (i < 0) {
+                throwInvalid(invalid_alphabet);
+            }
+            /* every character once (base32 is not case sensitive), padding included */
+            bool used[256] = { false };
+            for (size_t k = 0; k < a.size(); k++) {
+                unsigned char c = (i == 0) ? (unsigned char)tolower(a[k]) : (unsigned char)a[k];
+                if (used[c]) {
+                    throwInvalid(invalid_alphabet);
+                }
+                used[c] = true;
+            }
+            if (!alphabets[i].setup(a.substr(0, length).c_str(), padding)) {
+                throwInvalid(invalid_alphabet);
+            }
+            custom[i] = &alphabets[i];
+        }
+    }
+
     /* -k --key-derivation , i.e.:
             -k scrypt:13:8:3 [scrypt with N=2^13, r=8, p=3]
             -k pbkdf2:sha3:256:1000 [pbkdf2 with sha3-256 and 1000 iterations]
@@ -643,6 +713,14 @@ namespace check
         if (nppcrypt::help::checkProperty(options.algorithm, nppcrypt::KEY_REQUIRED) && !options.use_key) {
             throwInvalid(hash_requires_key);
         }
+
+        if (opt.hash_custom->count()) {
+            if (options.algorithm == nppcrypt::Hash::parallelhash128 || options.algorithm == nppcrypt::Hash::parallelhash256) {
+                options.customization.assign(args.hash_custom);
+            } else if (!*opt.silent) {
+                std::cout << nppcrypt::help::getString(options.algorithm) << " does not support a customization string. ignoring --hash-custom ..." << std::endl;
+            }
+        }
     }
 }
 
@@ -682,7 +760,7 @@ namespace print
     void initdata(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata)
     {
         using namespace nppcrypt;
-        secure_string tstr;
+        std::string tstr;
         if (options.key.salt_bytes && initdata.salt.size()) {
             initdata.salt.get(tstr, nppcrypt::Encoding::base64);
             std::cout << "Salt: " << tstr << std::endl;;
@@ -797,6 +875,46 @@ void hash(const nppcrypt::byte* input, size_t input_length)
     }
 }
 
+/* several files: one "digest  filename" line per file */
+void hash(const std::vector<std::string>& files)
+{
+    std::basic_string<nppcrypt::byte>    buffer;
+    std::basic_string<nppcrypt::byte>    digest;
+    nppcrypt::Options::Hash              options;
+    nppcrypt::Options::Convert           convert;
+    std::ostringstream                out;
+
+    if (opt.encoding->count() && !nppcrypt::help::getEncoding(args.encoding.c_str(), options.encoding)) {
+        throwInvalid(invalid_encoding);
+    }
+    if (opt.hash->count()) {
+        check::hash(options);
+    } else {
+        options.algorithm = nppcrypt::Hash::md5;
+        options.digest_length = 16;
+    }
+    nppcrypt::hash(options, buffer, files);
+
+    convert.to = options.encoding;
+    convert.linebreaks = false;
+    size_t digest_length = buffer.size() / files.size();
+    for (size_t i = 0; i < files.size(); i++) {
+        digest.clear();
+        nppcrypt::convert(&buffer[i * digest_length], digest_length, digest, convert);
+        out << (const char*)digest.c_str() << "  " << files[i] << std::endl;
+    }
+
+    if (opt.output->count()) {
+        std::string temp = out.str();
+        FileWriter fout(args.output);
+        if (!fout.write((const nppcrypt::byte*)temp.c_str(), temp.size())) {
+            throwError(failed_to_write_file);
+        }
+    } else {
+        std::cout << out.str();
+    }
+}
+
 void decrypt(const nppcrypt::byte* input, size_t input_length, File::BOM bom)
 {
     std::basic_string<nppcrypt::byte>  outputData;
@@ -856,7 +974,7 @@ void decrypt(const nppcrypt::byte* input, size_t input_length, File::BOM bom)
 
 void encrypt(const nppcrypt::byte* input, size_t input_length)
 {
-    std::basic_string<nppcrypt::byte>  outputData;
+    nppcrypt::SegmentedBuffer          outputData;
     nppcrypt::Options::Crypt           options;
     nppcrypt::UserData                 password;
     CryptHeader::HMAC               hmac;
@@ -872,7 +990,7 @@ void encrypt(const nppcrypt::byte* input, size_t input_length)
     check::iv(options, init.iv, false);
     check::keyderivation(options);
     check::salt(options);
-    check::encoding(options);
+    check::encoding(options.encoding);
     check::hmac(hmac);
     check::outputfile();
 
@@ -886,24 +1004,66 @@ void encrypt(const nppcrypt::byte* input, size_t input_length)
     nppcrypt::encrypt(input, input_length, outputData, options, password, init);
 
     if (create_header) {
-        header.create(options, init, outputData.c_str(), outputData.size());
+        header.create(options, init, outputData);
     }
+    /* the segments are written as they are, without joining them first */
     if (write_to_file) {
-        FileWriter fout(args.output);
-        if (!fout.write(outputData.c_str(), outputData.size(), header.c_str(), header.size())) {
+        if (!writeSegments(args.output, header.c_str(), header.size(), outputData)) {
             throwError(failed_to_write_file);
         }
         if (verbose || !create_header) {
             print::initdata(options, init);
         }
     } else {
-        if (header.size()) {
-            std::cout << header.c_str();
-        }
         if (verbose && !create_header) {
             print::initdata(options, init);
         }
-        std::cout << outputData.c_str() << std::endl;
+        if (!writeSegments("", header.c_str(), header.size(), outputData)) {
+            throwError(failed_to_write_file);
+        }
+        std::cout << std::endl;
+    }
+}
+
+/* streams input (file, string or stdin) to the output file or stdout */
+void convert()
+{
+    nppcrypt::Options::Convert         options;
+    nppcrypt::EncodingAlphabet         alphabets[3];
+    const nppcrypt::EncodingAlphabet*  custom[3] = { NULL, NULL, NULL };
+
+    check::convert(options);
+    check::alphabets(alphabets, custom);
+    check::outputfile();
+
+    nppcrypt::help::validate(options);
+
+    std::ifstream fin;
+    std::istringstream sin;
+    std::istream* in = &std::cin;
+    if (*opt.input && args.input.compare("-") != 0) {
+        if (File::exists(args.input)) {
+            fin.open(args.input, std::ios::in | std::ios::binary);
+            if (!fin.is_open()) {
+                throwError(failed_to_read_file);
+            }
+            in = &fin;
+        } else {
+            sin.str(args.input);
+            in = &sin;
+        }
+    }
+    setBinaryIO();
+
+    if (opt.output->count()) {
+        if (!*opt.silent) {
+            print::outputfile();
+        }
+        FileWriter fout(args.output);
+        nppcrypt::convert(*in, fout.getStream(), options, custom[0], custom[1], custom[2]);
+    } else {
+        nppcrypt::convert(*in, std::cout, options, custom[0], custom[1], custom[2]);
+        std::cout.flush();
     }
 }
 
@@ -916,25 +1076,37 @@ int main(int argc, char** argv)
         Action action;
 
         // setup CLI11 parser
-        opt.action = app.add_option("action", args.action, "(enc|dec|hash)");
-        opt.input = app.add_option("input", args.input, "input (file or string)");
-        opt.hash = app.add_option("-a,--algorithm", args.hash, "*hash-algorithm*[:Digestlength] i.e.: sha3:512 (adler32|blake2b|blake2s|cmac_aes|crc32|keccak|md2|md4|md5|ripemd|sha1|sha2|sha3|siphash24|siphash48|sm3|tiger|whirlpool)");
-        opt.password = app.add_option("-p,--password", args.password, "[(utf8|hex|base32|base64):]*password* , default encoding: utf8");
+        opt.action = app.add_option("action", args.action, "(enc|dec|hash|convert)");
+        opt.input = app.add_option("input", args.input, "input (file or string), convert: none or - for stdin");
+        opt.inputs = app.add_option("inputs", args.inputs, "further input files (hash only)");
+        opt.hash = app.add_option("-a,--algorithm", args.hash, "*hash-algorithm*[:Digestlength] i.e.: sha3:512 (adler32|blake2b|blake2s|cmac_aes|crc32|crc32c|keccak|md2|md4|md5|parallelhash128|parallelhash256|ripemd|sha1|sha2|sha3|siphash24|siphash48|sm3|tiger|whirlpool|xxh3)");
+        opt.password = app.add_option("-p,--password", args.password, "[(utf8|hex|base32|base64|base85):]*password* , default encoding: utf8");
         opt.output = app.add_option("-o,--output", args.output, "output file");
         opt.cipher = app.add_option("-c,--cipher", args.cipher, "cipher[:keylength[:mode]] i.e. camellia:256:cbc, default: rijndael:256:gcm\nciphers: (threeway|aria|blowfish|btea|camellia|cast128|cast256|chacha20|des|des_ede2|des_ede3|desx|gost|idea|kalyna128|kalyna256|kalyna512|mars|panama|rc2|rc4|rc5|rc6|rijndael|saferk|safersk|salsa20|seal|seed|serpent|shacal2|shark|simon128|skipjack|sm4|sosemanuk|speck128|square|tea|threefish256|threefish512|threefish1024|twofish|wake|xsalsa20|xtea),\nmodes: (ecb|cbc|cbc_cts|cfb|ofb|ctr|eax|ccm|gcm)");
         opt.keyderivation = app.add_option("-k,--key-derivation", args.keyderivation, "key derivation algorithm [default: scrypt]: (pbkdf2|bcrypt|scrypt)[:*option1*[:*option2*[:*option3*]]]");
-        opt.encoding = app.add_option("-e,--encoding", args.encoding, "encoding [default:base64]: (ascii|base16|base32|base64)[:(windows|unix)[:*linelength*[:*uppercase(true|false)*]]]");
-        opt.tag = app.add_option("-t,--tag", args.tag, "tag-value: [(utf8|hex|base32|base64):]*tagdata* , default-encoding: base64");
-        opt.salt = app.add_option("-s,--salt", args.salt, "salt-value: [(utf8|hex|base32|base64):]*saltdata* , default-encoding: base64");
-        opt.iv = app.add_option("-v,--iv", args.iv, "IV: (random|keyderivation|zero) OR [(utf8|hex|base32|base64):]*ivdata* , default encoding: base64");
+        opt.encoding = app.add_option("-e,--encoding", args.encoding, "encoding [default:base64] (convert: target encoding): (ascii|base16|base32|base64|base85)[:(windows|unix)[:*linelength*[:*uppercase(true|false)*]]]");
+        opt.from = app.add_option("-f,--from", args.from, "convert: source encoding [default: ascii]: (ascii|base16|base32|base64|base85)");
+        opt.alphabets = app.add_option("--alphabet", args.alphabets, "convert: custom base32 (32 characters), base64 (64) or base85 (85 characters, or z85|rfc1924) alphabet, base32/base64 optionally followed by the padding character");
+        opt.tag = app.add_option("-t,--tag", args.tag, "tag-value: [(utf8|hex|base32|base64|base85):]*tagdata* , default-encoding: base64");
+        opt.salt = app.add_option("-s,--salt", args.salt, "salt-value: [(utf8|hex|base32|base64|base85):]*saltdata* , default-encoding: base64");
+        opt.iv = app.add_option("-v,--iv", args.iv, "IV: (random|keyderivation|zero) OR [(utf8|hex|base32|base64|base85):]*ivdata* , default encoding: base64");
         opt.hmac = app.add_option("--hmac", args.hmac, "create hmac to authenticate header and encrypted data: hash:length i.e. sha3:256");
-        opt.hash_key = app.add_option("--hash-key", args.hash_key, "hash-key: [(utf8|hex|base32|base64):]*key* , default-encoding: utf8");
+        opt.hash_key = app.add_option("--hash-key", args.hash_key, "hash-key: [(utf8|hex|base32|base64|base85):]*key* , default-encoding: utf8");
+        opt.hash_custom = app.add_option("--hash-custom", args.hash_custom, "customization string (utf8) of parallelhash128/256");
         opt.noheader = app.add_flag("--noheader", "no header output");
         opt.silent = app.add_flag("--silent", "silent mode");
         opt.nointeraction = app.add_flag("--auto", "no user interaction");
 
         app.parse(argc, argv);
 
+        if (args.action.compare("convert") == 0) {
+            if (opt.inputs->count()) {
+                throwInvalid(invalid_cmdline_action);
+            }
+            convert();
+            return 0;
+        }
+
         if (!*opt.input) {
             // if only one positional argument is present: default to hash
             // ( can probably be done more elegantly ... )
@@ -952,6 +1124,21 @@ int main(int argc, char** argv)
             }
         }
         
+        if (opt.inputs->count()) {
+            if (action != Action::hash) {
+                throwInvalid(invalid_cmdline_action);
+            }
+            std::vector<std::string> files(1, args.input);
+            files.insert(files.end(), args.inputs.begin(), args.inputs.end());
+            for (const std::string& f : files) {
+                if (!File::exists(f)) {
+                    throwError(failed_to_read_file);
+                }
+            }
+            hash(files);
+            return 0;
+        }
+
         std::basic_string<nppcrypt::byte> inputData;
         File::BOM bom = File::BOM::none;
 
@@ -0,0 +1,739 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <vector>
+#include <algorithm>
+#include "codec.h"
+#include "cryptopp/cpu.h"
+
+using namespace nppcrypt;
+using namespace nppcrypt::codec;
+using CryptoPP::word32;
+using CryptoPP::word64;
+
+namespace
+{
+    const char base16_upper[] = "0123456789ABCDEF";
+    const char base16_lower[] = "0123456789abcdef";
+    /* the default alphabet of the cryptopp Base32Encoder */
+    const char base32_upper[] = "ABCDEFGHIJKMNPQRSTUVWXYZ23456789";
+    const char base32_lower[] = "abcdefghijkmnpqrstuvwxyz23456789";
+    const char base64_rfc4648[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    const char base85_overflow[] = "base85: invalid input (group value above 2^32 - 1).";
+
+    /* characters encoded to a buffer at once if lines end inside a group */
+    const size_t wrap_chunk = 4096;
+
+    size_t workerCount(size_t length)
+    {
+        /* small inputs (i.e. the chunks of encrypt/decrypt) do not ask for the number of cores */
+        if (length < 2 * Constants::codec_thread_min) {
+            return 1;
+        }
+        size_t threads = std::thread::hardware_concurrency();
+        if (threads <= 1) {
+            return 1;
+        }
+        return std::min(threads, length / Constants::codec_thread_min);
+    }
+
+    /* job(0) ... job(count - 1), each on its own thread. The first exception of a job is rethrown once all of them have finished */
+    template<class Job> void parallel(size_t count, const Job& job)
+    {
+        std::exception_ptr error;
+        std::mutex lock;
+        auto run = [&](size_t i) {
+            try {
+                job(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        };
+        std::vector<std::thread> workers;
+        workers.reserve(count - 1);
+        size_t i = 1;
+        try {
+            for (; i < count; i++) {
+                workers.emplace_back(std::cref(run), i);
+            }
+        } catch (...) {
+            /* failed to start another thread: the remaining jobs run on this one */
+        }
+        for (; i < count; i++) {
+            run(i);
+        }
+        run(0);
+        for (std::thread& t : workers) {
+            t.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    size_t gcd(size_t a, size_t b)
+    {
+        while (b) {
+            size_t t = a % b;
+            a = b;
+            b = t;
+        }
+        return a;
+    }
+}
+
+const char nppcrypt::codec::base85_z85[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+const char nppcrypt::codec::base85_rfc1924[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!#$%&()*+-;<=>?@^_`{|}~";
+
+// ===========================================================================================================================================================================================
+
+size_t nppcrypt::codec::Codec::encodedChars(size_t length) const
+{
+    return (length + group_bytes - 1) / group_bytes * group_chars;
+}
+
+size_t nppcrypt::codec::Codec::encodedSize(size_t length, size_t linelength, size_t eol_length) const
+{
+    size_t chars = encodedChars(length);
+    if (linelength && chars > linelength) {
+        chars += (chars - 1) / linelength * eol_length;
+    }
+    return chars;
+}
+
+size_t nppcrypt::codec::Codec::encode(const byte* in, size_t length, byte* out, size_t linelength, const std::string& eol) const
+{
+    size_t threads = workerCount(length);
+    if (threads <= 1) {
+        return encodeRange(in, length, out, linelength, eol);
+    }
+    /* slices of whole groups and lines: every slice but the first starts a line, after an eol written here */
+    size_t unit = lineBytes(linelength);
+    size_t slice = (length / threads + unit - 1) / unit * unit;
+    size_t gap = linelength ? eol.size() : 0;
+    size_t stride = encodedSize(slice, linelength, eol.size()) + gap;
+
+    parallel((length + slice - 1) / slice, [&](size_t i) {
+        byte* p = out + i * stride;
+        if (i) {
+            std::memcpy(p - gap, eol.data(), gap);
+        }
+        encodeRange(in + i * slice, std::min(slice, length - i * slice), p, linelength, eol);
+    });
+    return encodedSize(length, linelength, eol.size());
+}
+
+size_t nppcrypt::codec::Codec::lineBytes(size_t linelength) const
+{
+    size_t line = linelength ? linelength : group_chars;
+    return line / gcd(line, group_chars) * group_bytes;
+}
+
+size_t nppcrypt::codec::Codec::encodeRange(const byte* in, size_t length, byte* out, size_t linelength, const std::string& eol) const
+{
+    size_t chars = encodedChars(length);
+    byte* p = out;
+
+    if (!linelength || chars <= linelength) {
+        p = encodeBlock(in, length, length, p, true);
+    } else if (linelength % group_chars == 0) {
+        /* lines end on group boundaries: every line is encoded in place */
+        size_t line = linelength / group_chars * group_bytes;
+        for (; length > line; in += line, length -= line) {
+            p = encodeBlock(in, line, length, p, false);
+            std::memcpy(p, eol.data(), eol.size());
+            p += eol.size();
+        }
+        p = encodeBlock(in, length, length, p, true);
+    } else {
+        byte buffer[wrap_chunk];
+        size_t chunk = wrap_chunk / group_chars * group_bytes;
+        size_t column = 0;
+        while (length) {
+            size_t n = (length < chunk) ? length : chunk;
+            const byte* end = encodeBlock(in, n, length, buffer, n == length);
+            in += n;
+            length -= n;
+            for (const byte* b = buffer; b < end;) {
+                if (column == linelength) {
+                    std::memcpy(p, eol.data(), eol.size());
+                    p += eol.size();
+                    column = 0;
+                }
+                size_t k = linelength - column;
+                if (k > (size_t)(end - b)) {
+                    k = end - b;
+                }
+                std::memcpy(p, b, k);
+                p += k;
+                b += k;
+                column += k;
+            }
+        }
+    }
+    return p - out;
+}
+
+void nppcrypt::codec::Codec::encode(const byte* in, size_t length, std::basic_string<byte>& out, size_t linelength, const std::string& eol) const
+{
+    size_t size = encodedSize(length, linelength, eol.size());
+    if (size) {
+        size_t offset = out.size();
+        out.resize(offset + size);
+        encode(in, length, &out[offset], linelength, eol);
+    }
+}
+
+size_t nppcrypt::codec::Codec::decode(const byte* in, size_t length, byte* out) const
+{
+    size_t threads = workerCount(length);
+    if (threads <= 1) {
+        return decodeBlock(in, length, out);
+    }
+    const byte* end = in + length;
+    size_t chunk = length / threads;
+
+    /* characters of the alphabet in every chunk */
+    std::vector<size_t> counts(threads);
+    parallel(threads, [&](size_t i) {
+        counts[i] = countValid(in + i * chunk, (i + 1 < threads) ? chunk : length - i * chunk);
+    });
+
+    /* ranges start with a group: the characters that complete the last group of the previous chunk are skipped.
+       A range that would start behind the last group is empty, its predecessor decodes up to the end. */
+    std::vector<const byte*> starts(threads + 1, end);
+    std::vector<size_t> offsets(threads, 0);
+    size_t last = 0;
+    size_t before = 0;
+    starts[0] = in;
+    for (size_t i = 1; i < threads; i++) {
+        before += counts[i - 1];
+        size_t skip = (group_chars - before % group_chars) % group_chars;
+        const byte* s = in + i * chunk;
+        for (; skip && s < end; s++) {
+            if (values[*s] != 0xff) {
+                skip--;
+            }
+        }
+        if (skip || s == end) {
+            break;
+        }
+        starts[i] = s;
+        offsets[i] = (before + group_chars - 1) / group_chars * group_bytes;
+        last = i;
+    }
+
+    std::vector<size_t> written(threads, 0);
+    parallel(last + 1, [&](size_t i) {
+        written[i] = decodeBlock(starts[i], starts[i + 1] - starts[i], out + offsets[i]);
+    });
+    return offsets[last] + written[last];
+}
+
+size_t nppcrypt::codec::Codec::countValid(const byte* in, size_t length) const
+{
+    size_t n = 0;
+    for (size_t i = 0; i < length; i++) {
+        n += (values[in[i]] != 0xff);
+    }
+    return n;
+}
+
+size_t nppcrypt::codec::Codec::groupsLength(const byte* in, size_t length) const
+{
+    /* the prefix ends in front of the characters of the incomplete last group */
+    size_t rest = countValid(in, length) % group_chars;
+    size_t i = length;
+    for (; rest && i; i--) {
+        if (values[in[i - 1]] != 0xff) {
+            rest--;
+        }
+    }
+    return i;
+}
+
+void nppcrypt::codec::Codec::decode(const byte* in, size_t length, std::basic_string<byte>& out) const
+{
+    size_t size = decodedSize(length);
+    if (size) {
+        size_t offset = out.size();
+        out.resize(offset + size);
+        out.resize(offset + decode(in, length, &out[offset]));
+    }
+}
+
+// ===========================================================================================================================================================================================
+
+nppcrypt::codec::Base16::Base16(bool uppercase) : Codec(1, 2)
+{
+    std::memcpy(alphabet, uppercase ? base16_upper : base16_lower, 16);
+    std::memset(values, 0xff, sizeof(values));
+    for (int i = 0; i < 16; i++) {
+        values[(byte)base16_upper[i]] = (byte)i;
+        values[(byte)base16_lower[i]] = (byte)i;
+    }
+}
+
+byte* nppcrypt::codec::Base16::encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const
+{
+    size_t blocks;
+#if (CRYPTOPP_AVX2_AVAILABLE)
+    if (CryptoPP::HasAVX2()) {
+        blocks = length / 32;
+        simd::base16_encode_avx2(in, blocks, out, alphabet);
+        in += 32 * blocks;
+        length -= 32 * blocks;
+        out += 64 * blocks;
+    }
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+    if (CryptoPP::HasSSSE3()) {
+        blocks = length / 16;
+        simd::base16_encode_ssse3(in, blocks, out, alphabet);
+        in += 16 * blocks;
+        length -= 16 * blocks;
+        out += 32 * blocks;
+    }
+#endif
+    for (; length; length--, in++, out += 2) {
+        out[0] = alphabet[*in >> 4];
+        out[1] = alphabet[*in & 0x0f];
+    }
+    return out;
+}
+
+size_t nppcrypt::codec::Base16::decodeBlock(const byte* in, size_t length, byte* out) const
+{
+    const byte* end = in + length;
+    byte* p = out;
+    unsigned int hi = 0;
+    bool half = false;
+
+    while (in < end) {
+        /* up to the next line break or other character that is not a hex digit */
+        size_t chars = 0;
+#if (CRYPTOPP_AVX2_AVAILABLE)
+        if (CryptoPP::HasAVX2()) {
+            chars = simd::base16_decode_avx2(in, (end - in) / 32, p);
+        } else
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+        if (CryptoPP::HasSSSE3()) {
+            chars = simd::base16_decode_ssse3(in, (end - in) / 16, p);
+        }
+#endif
+        in += chars;
+        p += chars / 2;
+        /* the run of skipped characters and the pair it interrupts */
+        bool skipped = false;
+        for (; in < end; in++) {
+            byte v = values[*in];
+            if (v == 0xff) {
+                skipped = true;
+                continue;
+            }
+            if (skipped && !half) {
+                break;
+            }
+            if (half) {
+                *p++ = (byte)((hi << 4) | v);
+            } else {
+                hi = v;
+            }
+            half = !half;
+        }
+    }
+    return p - out;
+}
+
+// ===========================================================================================================================================================================================
+
+nppcrypt::codec::Base32::Base32(const EncodingAlphabet* a, bool uppercase) : Codec(5, 8)
+{
+    const byte* alpha = (const byte*)(uppercase ? base32_upper : base32_lower);
+    padding = 0;
+    if (a && a->c_str(true) && a->c_str(false)) {
+        alpha = a->c_str(uppercase);
+        padding = a->getPadding();
+    }
+    std::memcpy(alphabet, alpha, 32);
+    for (int i = 0; i < 1024; i++) {
+        pairs[i][0] = alphabet[i >> 5];
+        pairs[i][1] = alphabet[i & 0x1f];
+    }
+
+    std::memset(values, 0xff, sizeof(values));
+    if (a && a->c_str()) {
+        const int* lookup = a->getLookup();
+        for (int c = 0; c < 256; c++) {
+            if (lookup[c] >= 0 && lookup[c] < 32) {
+                values[c] = (byte)lookup[c];
+            }
+        }
+    } else {
+        for (int i = 0; i < 32; i++) {
+            values[(byte)base32_upper[i]] = (byte)i;
+            values[(byte)base32_lower[i]] = (byte)i;
+        }
+    }
+}
+
+size_t nppcrypt::codec::Base32::encodedChars(size_t length) const
+{
+    if (padding) {
+        return Codec::encodedChars(length);
+    }
+    return length / 5 * 8 + (length % 5 * 8 + 4) / 5;
+}
+
+byte* nppcrypt::codec::Base32::encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const
+{
+    /* 40 bit groups: four table lookups of 10 bits each */
+    for (; length >= 5; length -= 5, in += 5, out += 8) {
+        word64 v = ((word64)in[0] << 32) | ((word64)in[1] << 24) | ((word64)in[2] << 16) | ((word64)in[3] << 8) | in[4];
+        std::memcpy(out, pairs[v >> 30], 2);
+        std::memcpy(out + 2, pairs[(v >> 20) & 0x3ff], 2);
+        std::memcpy(out + 4, pairs[(v >> 10) & 0x3ff], 2);
+        std::memcpy(out + 6, pairs[v & 0x3ff], 2);
+    }
+    if (final && length) {
+        word64 v = 0;
+        for (size_t i = 0; i < length; i++) {
+            v |= (word64)in[i] << (32 - 8 * i);
+        }
+        size_t chars = (length * 8 + 4) / 5;
+        for (size_t i = 0; i < chars; i++) {
+            out[i] = alphabet[(v >> (35 - 5 * i)) & 0x1f];
+        }
+        if (padding) {
+            std::memset(out + chars, padding, 8 - chars);
+            chars = 8;
+        }
+        out += chars;
+    }
+    return out;
+}
+
+size_t nppcrypt::codec::Base32::decodeBlock(const byte* in, size_t length, byte* out) const
+{
+    const byte* end = in + length;
+    byte* p = out;
+    word64 acc = 0;
+    unsigned int n = 0;
+
+    while (in < end) {
+        /* whole groups up to the next line break or other character outside the alphabet */
+        for (; end - in >= 8; in += 8, p += 5) {
+            word64 v = 0;
+            byte invalid = 0;
+            for (int i = 0; i < 8; i++) {
+                byte c = values[in[i]];
+                invalid |= c;
+                v = (v << 5) | c;
+            }
+            if (invalid & 0xe0) {
+                break;
+            }
+            p[0] = (byte)(v >> 32);
+            p[1] = (byte)(v >> 24);
+            p[2] = (byte)(v >> 16);
+            p[3] = (byte)(v >> 8);
+            p[4] = (byte)v;
+        }
+        /* the run of skipped characters and the group it interrupts */
+        bool skipped = false;
+        for (; in < end; in++) {
+            byte v = values[*in];
+            if (v == 0xff) {
+                skipped = true;
+                continue;
+            }
+            if (skipped && !n) {
+                break;
+            }
+            acc = (acc << 5) | v;
+            if (++n == 8) {
+                p[0] = (byte)(acc >> 32);
+                p[1] = (byte)(acc >> 24);
+                p[2] = (byte)(acc >> 16);
+                p[3] = (byte)(acc >> 8);
+                p[4] = (byte)acc;
+                p += 5;
+                acc = 0;
+                n = 0;
+            }
+        }
+    }
+    /* incomplete last group: whole bytes only */
+    for (unsigned int bits = 5 * n; bits >= 8; bits -= 8) {
+        *p++ = (byte)(acc >> (bits - 8));
+    }
+    return p - out;
+}
+
+// ===========================================================================================================================================================================================
+
+nppcrypt::codec::Base64::Base64(const EncodingAlphabet* a) : Codec(3, 4)
+{
+    const byte* alpha = (a && a->c_str()) ? a->c_str() : (const byte*)base64_rfc4648;
+    std::memcpy(alphabet, alpha, 64);
+    padding = (a && a->getPadding()) ? a->getPadding() : '=';
+
+    std::memset(values, 0xff, sizeof(values));
+    if (a && a->c_str()) {
+        const int* lookup = a->getLookup();
+        for (int c = 0; c < 256; c++) {
+            if (lookup[c] >= 0 && lookup[c] < 64) {
+                values[c] = (byte)lookup[c];
+            }
+        }
+    } else {
+        for (int i = 0; i < 64; i++) {
+            values[alphabet[i]] = (byte)i;
+        }
+    }
+    simd_decode = true;
+    for (int c = 0; c < 256; c++) {
+        if (c < 128) {
+            tables[c] = (values[c] == 0xff) ? 0x80 : values[c];
+        } else if (values[c] != 0xff) {
+            simd_decode = false;
+        }
+    }
+}
+
+byte* nppcrypt::codec::Base64::encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const
+{
+    size_t blocks;
+#if (CRYPTOPP_AVX2_AVAILABLE)
+    if (readable >= 28 && CryptoPP::HasAVX2()) {
+        blocks = length / 24;
+        if (blocks > (readable - 4) / 24) {
+            blocks = (readable - 4) / 24;
+        }
+        simd::base64_encode_avx2(in, blocks, out, alphabet);
+        in += 24 * blocks;
+        length -= 24 * blocks;
+        readable -= 24 * blocks;
+        out += 32 * blocks;
+    }
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+    if (readable >= 16 && CryptoPP::HasSSSE3()) {
+        blocks = length / 12;
+        if (blocks > (readable - 4) / 12) {
+            blocks = (readable - 4) / 12;
+        }
+        simd::base64_encode_ssse3(in, blocks, out, alphabet);
+        in += 12 * blocks;
+        length -= 12 * blocks;
+        out += 16 * blocks;
+    }
+#endif
+    for (; length >= 3; length -= 3, in += 3, out += 4) {
+        word32 v = ((word32)in[0] << 16) | ((word32)in[1] << 8) | in[2];
+        out[0] = alphabet[v >> 18];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = alphabet[(v >> 6) & 0x3f];
+        out[3] = alphabet[v & 0x3f];
+    }
+    if (final && length) {
+        word32 v = ((word32)in[0] << 16) | ((length == 2) ? ((word32)in[1] << 8) : 0);
+        out[0] = alphabet[v >> 18];
+        out[1] = alphabet[(v >> 12) & 0x3f];
+        out[2] = (length == 2) ? alphabet[(v >> 6) & 0x3f] : padding;
+        out[3] = padding;
+        out += 4;
+    }
+    return out;
+}
+
+size_t nppcrypt::codec::Base64::decodeBlock(const byte* in, size_t length, byte* out) const
+{
+    const byte* end = in + length;
+    byte* p = out;
+    word32 acc = 0;
+    unsigned int n = 0;
+
+    while (in < end) {
+        /* up to the next line break or other character outside the alphabet */
+        if (simd_decode) {
+            size_t chars = 0;
+#if (CRYPTOPP_AVX2_AVAILABLE)
+            if (CryptoPP::HasAVX2()) {
+                chars = simd::base64_decode_avx2(in, (end - in) / 32, p, tables);
+            } else
+#endif
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+            if (CryptoPP::HasSSSE3()) {
+                chars = simd::base64_decode_ssse3(in, (end - in) / 16, p, tables);
+            }
+#endif
+            in += chars;
+            p += chars / 4 * 3;
+        }
+        /* the run of skipped characters and the group it interrupts */
+        bool skipped = false;
+        for (; in < end; in++) {
+            byte v = values[*in];
+            if (v == 0xff) {
+                skipped = true;
+                continue;
+            }
+            if (skipped && !n) {
+                break;
+            }
+            acc = (acc << 6) | v;
+            if (++n == 4) {
+                p[0] = (byte)(acc >> 16);
+                p[1] = (byte)(acc >> 8);
+                p[2] = (byte)acc;
+                p += 3;
+                acc = 0;
+                n = 0;
+            }
+        }
+    }
+    /* incomplete last group: whole bytes only */
+    if (n == 2) {
+        *p++ = (byte)(acc >> 4);
+    } else if (n == 3) {
+        *p++ = (byte)(acc >> 10);
+        *p++ = (byte)(acc >> 2);
+    }
+    return p - out;
+}
+
+// ===========================================================================================================================================================================================
+
+nppcrypt::codec::Base85::Base85(const EncodingAlphabet* a) : Codec(4, 5)
+{
+    const byte* alpha = (a && a->c_str()) ? a->c_str() : (const byte*)base85_z85;
+    std::memcpy(alphabet, alpha, 85);
+
+    std::memset(values, 0xff, sizeof(values));
+    for (int i = 0; i < 85; i++) {
+        values[alphabet[i]] = (byte)i;
+    }
+}
+
+size_t nppcrypt::codec::Base85::encodedChars(size_t length) const
+{
+    return length / 4 * 5 + ((length % 4) ? length % 4 + 1 : 0);
+}
+
+byte* nppcrypt::codec::Base85::encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const
+{
+    for (; length >= 4; length -= 4, in += 4, out += 5) {
+        word32 v = ((word32)in[0] << 24) | ((word32)in[1] << 16) | ((word32)in[2] << 8) | in[3];
+        for (int i = 4; i >= 0; i--) {
+            out[i] = alphabet[v % 85];
+            v /= 85;
+        }
+    }
+    if (final && length) {
+        /* zero padded group, only the leading length + 1 characters are written */
+        byte digits[5];
+        word32 v = 0;
+        for (size_t i = 0; i < 4; i++) {
+            v = (v << 8) | ((i < length) ? in[i] : 0);
+        }
+        for (int i = 4; i >= 0; i--) {
+            digits[i] = alphabet[v % 85];
+            v /= 85;
+        }
+        std::memcpy(out, digits, length + 1);
+        out += length + 1;
+    }
+    return out;
+}
+
+size_t nppcrypt::codec::Base85::decodeBlock(const byte* in, size_t length, byte* out) const
+{
+    const byte* end = in + length;
+    byte* p = out;
+    /* 5 digits reach 85^5 - 1 > 2^32 - 1: groups are summed in 64 bits and larger values rejected (as python's b85decode) */
+    word64 acc = 0;
+    unsigned int n = 0;
+
+    while (in < end) {
+        /* whole groups up to the next line break or other character outside the alphabet */
+        for (; end - in >= 5; in += 5, p += 4) {
+            word64 v = 0;
+            byte invalid = 0;
+            for (int i = 0; i < 5; i++) {
+                byte c = values[in[i]];
+                invalid |= c;
+                v = v * 85 + c;
+            }
+            if (invalid & 0x80) {
+                break;
+            }
+            if (v > 0xffffffff) {
+                throw ExceptionArguments(base85_overflow);
+            }
+            p[0] = (byte)(v >> 24);
+            p[1] = (byte)(v >> 16);
+            p[2] = (byte)(v >> 8);
+            p[3] = (byte)v;
+        }
+        /* the run of skipped characters and the group it interrupts */
+        bool skipped = false;
+        for (; in < end; in++) {
+            byte v = values[*in];
+            if (v == 0xff) {
+                skipped = true;
+                continue;
+            }
+            if (skipped && !n) {
+                break;
+            }
+            acc = acc * 85 + v;
+            if (++n == 5) {
+                if (acc > 0xffffffff) {
+                    throw ExceptionArguments(base85_overflow);
+                }
+                p[0] = (byte)(acc >> 24);
+                p[1] = (byte)(acc >> 16);
+                p[2] = (byte)(acc >> 8);
+                p[3] = (byte)acc;
+                p += 4;
+                acc = 0;
+                n = 0;
+            }
+        }
+    }
+    /* incomplete last group: padded with the highest digit, n - 1 bytes (a single digit is still checked for overflow) */
+    if (n > 0) {
+        for (unsigned int i = n; i < 5; i++) {
+            acc = acc * 85 + 84;
+        }
+        if (acc > 0xffffffff) {
+            throw ExceptionArguments(base85_overflow);
+        }
+        for (unsigned int i = 0; i < n - 1; i++) {
+            *p++ = (byte)(acc >> (24 - 8 * i));
+        }
+    }
+    return p - out;
+}
@@ -0,0 +1,171 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef CODEC_H_DEF
+#define CODEC_H_DEF
+
+#include <string>
+#include "crypt.h"
+
+/* text encodings of whole buffers in one pass, without the cryptopp BaseN_Encoder/Grouper filter chain.
+   Line breaks are written inline, base16/base64 blocks are translated with SSSE3/AVX2 if available (see codec_simd.cpp, codec_avx2.cpp),
+   base32 groups of 40 bits with 10 bit lookup tables, base85 groups of 32 bits.
+   The output is identical to the cryptopp encoders and decoders nppcrypt used before:
+   eol is inserted between lines (not after the last one), decoders skip every character outside the alphabet.
+   Inputs of several MiB are split among threads (Constants::codec_thread_min bytes each at least). */
+namespace nppcrypt
+{
+    namespace codec
+    {
+        class Codec
+        {
+        public:
+            virtual ~Codec() {};
+
+            /* number of characters encode() writes, linelength 0: no line breaks */
+            size_t          encodedSize(size_t length, size_t linelength = 0, size_t eol_length = 0) const;
+            /* upper bound of the number of bytes decode() writes */
+            virtual size_t  decodedSize(size_t length) const = 0;
+
+            /* out: encodedSize() characters, returns encodedSize(). Slices of large inputs are encoded concurrently */
+            size_t          encode(const byte* in, size_t length, byte* out, size_t linelength = 0, const std::string& eol = "") const;
+            /* appends to out */
+            void            encode(const byte* in, size_t length, std::basic_string<byte>& out, size_t linelength = 0, const std::string& eol = "") const;
+            /* out: decodedSize() bytes, returns the number of bytes written. Large inputs are split at group boundaries and decoded concurrently */
+            size_t          decode(const byte* in, size_t length, byte* out) const;
+            /* appends to out */
+            void            decode(const byte* in, size_t length, std::basic_string<byte>& out) const;
+            /* decode() with out == in on a single thread: the output never overtakes the input, the slices of the parallel decoder would */
+            size_t          decodeInPlace(byte* data, size_t length) const { return decodeBlock(data, length, data); };
+
+            /* streams: inputs split at multiples of lineBytes() encode to whole lines (whole groups if linelength is 0), joined by eol */
+            size_t          lineBytes(size_t linelength) const;
+            /* streams: length of the longest prefix of in that holds whole groups. Decoding it and the rest separately equals decoding in */
+            size_t          groupsLength(const byte* in, size_t length) const;
+
+        protected:
+            /* group bytes are encoded to chars characters */
+            Codec(size_t group, size_t chars) : group_bytes(group), group_chars(chars) {};
+
+            /* number of characters of length bytes without line breaks, default: padded groups */
+            virtual size_t  encodedChars(size_t length) const;
+
+            /* whole groups of in, the incomplete last group only if final. readable: number of bytes at in that may be read */
+            virtual byte*   encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const = 0;
+            virtual size_t  decodeBlock(const byte* in, size_t length, byte* out) const = 0;
+
+            size_t          group_bytes;
+            size_t          group_chars;
+            /* value of every character, 0xff if it is not part of the alphabet */
+            byte            values[256];
+
+        private:
+            /* encode() on a single thread */
+            size_t          encodeRange(const byte* in, size_t length, byte* out, size_t linelength, const std::string& eol) const;
+            /* number of characters of the alphabet in in */
+            size_t          countValid(const byte* in, size_t length) const;
+        };
+
+        class Base16 : public Codec
+        {
+        public:
+            Base16(bool uppercase = true);
+            size_t          decodedSize(size_t length) const { return length / 2; };
+
+        private:
+            byte*           encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const;
+            size_t          decodeBlock(const byte* in, size_t length, byte* out) const;
+
+            byte            alphabet[16];
+        };
+
+        class Base32 : public Codec
+        {
+        public:
+            /* alphabet NULL: the cryptopp default alphabet, no padding */
+            Base32(const EncodingAlphabet* alphabet = NULL, bool uppercase = true);
+            size_t          decodedSize(size_t length) const { return length / 8 * 5 + (length % 8) * 5 / 8; };
+
+        private:
+            size_t          encodedChars(size_t length) const;
+            byte*           encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const;
+            size_t          decodeBlock(const byte* in, size_t length, byte* out) const;
+
+            byte            alphabet[32];
+            byte            padding;
+            /* both characters of every 10 bit value */
+            byte            pairs[1024][2];
+        };
+
+        class Base64 : public Codec
+        {
+        public:
+            /* alphabet NULL: RFC 4648, '=' padding */
+            Base64(const EncodingAlphabet* alphabet = NULL);
+            size_t          decodedSize(size_t length) const { return length / 4 * 3 + (length % 4) * 3 / 4; };
+
+        private:
+            byte*           encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const;
+            size_t          decodeBlock(const byte* in, size_t length, byte* out) const;
+
+            byte            alphabet[64];
+            byte            padding;
+            /* values of the characters 0-127 for the SIMD decoders, 0x80 if invalid */
+            byte            tables[128];
+            bool            simd_decode;
+        };
+
+        class Base85 : public Codec
+        {
+        public:
+            /* alphabet NULL: Z85. No padding, the last group of n bytes is written as n + 1 characters.
+               The decoders throw ExceptionArguments if a group is above 2^32 - 1 */
+            Base85(const EncodingAlphabet* alphabet = NULL);
+            size_t          decodedSize(size_t length) const { return length / 5 * 4 + ((length % 5) ? length % 5 - 1 : 0); };
+
+        private:
+            size_t          encodedChars(size_t length) const;
+            byte*           encodeBlock(const byte* in, size_t length, size_t readable, byte* out, bool final) const;
+            size_t          decodeBlock(const byte* in, size_t length, byte* out) const;
+
+            byte            alphabet[85];
+        };
+
+        /* the 85 character alphabets of ZeroMQ (Z85) and RFC 1924, selected by name with the cli option --alphabet */
+        extern const char   base85_z85[];
+        extern const char   base85_rfc1924[];
+
+        namespace simd
+        {
+            /* 16 (ssse3) or 32 (avx2) bytes to 32/64 characters per block */
+            void    base16_encode_ssse3(const byte* in, size_t blocks, byte* out, const byte* alphabet);
+            void    base16_encode_avx2(const byte* in, size_t blocks, byte* out, const byte* alphabet);
+            /* 16 (ssse3) or 32 (avx2) characters to 8/16 bytes per block. Stops at the first character that is not a hex digit,
+               returns the number of characters decoded (whole pairs). Only the bytes of the decoded characters are written. */
+            size_t  base16_decode_ssse3(const byte* in, size_t blocks, byte* out);
+            size_t  base16_decode_avx2(const byte* in, size_t blocks, byte* out);
+
+            /* 12 (ssse3) or 24 (avx2) bytes to 16/32 characters per block, the 4 bytes after the last block are read */
+            void    base64_encode_ssse3(const byte* in, size_t blocks, byte* out, const byte* alphabet);
+            void    base64_encode_avx2(const byte* in, size_t blocks, byte* out, const byte* alphabet);
+            /* 16 (ssse3) or 32 (avx2) characters to 12/24 bytes per block. Stops at the first invalid character,
+               returns the number of characters decoded (whole groups of 4). Only the bytes of the decoded characters are written. */
+            size_t  base64_decode_ssse3(const byte* in, size_t blocks, byte* out, const byte* tables);
+            size_t  base64_decode_avx2(const byte* in, size_t blocks, byte* out, const byte* tables);
+        };
+    };
+};
+
+#endif
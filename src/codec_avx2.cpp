@@ -0,0 +1,168 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* AVX2 codec kernels, needs -mavx2 with gcc/clang (see GNUmakefile).
+   gcc does not insert vzeroupper at -Os: every kernel clears the upper halves itself before returning to SSE code. */
+
+#include <cstring>
+#include "codec.h"
+#include "cryptopp/misc.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <immintrin.h>
+#endif
+
+using CryptoPP::word32;
+
+namespace nppcrypt
+{
+namespace codec
+{
+namespace simd
+{
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+namespace
+{
+    inline __m256i broadcast(const byte* p)
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)p));
+    }
+
+    /* see codec_simd.cpp, the tables are repeated in both 128 bit lanes */
+    inline __m256i lookup64(__m256i index, const __m256i* table)
+    {
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(index, 4), _mm256_set1_epi8(0x0f));
+        __m256i r = _mm256_setzero_si256();
+        for (int k = 0; k < 4; k++) {
+            r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)k)), _mm256_shuffle_epi8(table[k], index)));
+        }
+        return r;
+    }
+
+    inline __m256i lookup128(__m256i c, const __m256i* table)
+    {
+        const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(c, 4), _mm256_set1_epi8(0x0f));
+        __m256i r = _mm256_and_si256(c, _mm256_set1_epi8((char)0x80));
+        for (int k = 0; k < 8; k++) {
+            r = _mm256_or_si256(r, _mm256_and_si256(_mm256_cmpeq_epi8(hi, _mm256_set1_epi8((char)k)), _mm256_shuffle_epi8(table[k], c)));
+        }
+        return r;
+    }
+
+    inline __m256i hexValues(__m256i c)
+    {
+        const __m256i digit = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+        const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+        const __m256i is_digit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+        const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+        __m256i r = _mm256_or_si256(_mm256_and_si256(is_digit, digit), _mm256_and_si256(is_letter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+        return _mm256_or_si256(r, _mm256_andnot_si256(_mm256_or_si256(is_digit, is_letter), _mm256_set1_epi8((char)0xff)));
+    }
+}
+
+void base16_encode_avx2(const byte* in, size_t blocks, byte* out, const byte* alphabet)
+{
+    const __m256i table = broadcast(alphabet);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    for (; blocks; blocks--, in += 32, out += 64) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)in);
+        __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+        __m256i a = _mm256_unpacklo_epi8(hi, lo);
+        __m256i b = _mm256_unpackhi_epi8(hi, lo);
+        _mm256_storeu_si256((__m256i*)out, _mm256_permute2x128_si256(a, b, 0x20));
+        _mm256_storeu_si256((__m256i*)(out + 32), _mm256_permute2x128_si256(a, b, 0x31));
+    }
+    _mm256_zeroupper();
+}
+
+size_t base16_decode_avx2(const byte* in, size_t blocks, byte* out)
+{
+    size_t done = 0;
+    for (; blocks; blocks--, done += 32) {
+        __m256i v = hexValues(_mm256_loadu_si256((const __m256i*)(in + done)));
+        word32 invalid = (word32)_mm256_movemask_epi8(v);
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi16(0x0110));
+        v = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), _MM_SHUFFLE(3, 1, 2, 0));
+        if (invalid) {
+            size_t valid = CryptoPP::TrailingZeros(invalid) & ~1;
+            byte temp[16];
+            _mm_storeu_si128((__m128i*)temp, _mm256_castsi256_si128(v));
+            std::memcpy(out + done / 2, temp, valid / 2);
+            done += valid;
+            break;
+        }
+        _mm_storeu_si128((__m128i*)(out + done / 2), _mm256_castsi256_si128(v));
+    }
+    _mm256_zeroupper();
+    return done;
+}
+
+void base64_encode_avx2(const byte* in, size_t blocks, byte* out, const byte* alphabet)
+{
+    __m256i table[4];
+    for (int k = 0; k < 4; k++) {
+        table[k] = broadcast(alphabet + 16 * k);
+    }
+    const __m256i spread = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                           10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    for (; blocks; blocks--, in += 24, out += 32) {
+        /* 12 bytes per lane */
+        __m256i v = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)in)), _mm_loadu_si128((const __m128i*)(in + 12)), 1);
+        v = _mm256_shuffle_epi8(v, spread);
+        __m256i ac = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+        __m256i bd = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+        _mm256_storeu_si256((__m256i*)out, lookup64(_mm256_or_si256(ac, bd), table));
+    }
+    _mm256_zeroupper();
+}
+
+size_t base64_decode_avx2(const byte* in, size_t blocks, byte* out, const byte* tables)
+{
+    __m256i table[8];
+    for (int k = 0; k < 8; k++) {
+        table[k] = broadcast(tables + 16 * k);
+    }
+    const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                          2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i join = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+    size_t done = 0;
+    for (; blocks; blocks--, done += 32) {
+        __m256i v = lookup128(_mm256_loadu_si256((const __m256i*)(in + done)), table);
+        word32 invalid = (word32)_mm256_movemask_epi8(v);
+        v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+        v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+        v = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, pack), join);
+        byte* o = out + done / 4 * 3;
+        if (invalid) {
+            size_t valid = CryptoPP::TrailingZeros(invalid) & ~3;
+            byte temp[32];
+            _mm256_storeu_si256((__m256i*)temp, v);
+            std::memcpy(o, temp, valid / 4 * 3);
+            done += valid;
+            break;
+        }
+        _mm_storeu_si128((__m128i*)o, _mm256_castsi256_si128(v));
+        _mm_storel_epi64((__m128i*)(o + 16), _mm256_extracti128_si256(v, 1));
+    }
+    _mm256_zeroupper();
+    return done;
+}
+#endif
+
+};
+};
+};
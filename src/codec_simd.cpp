@@ -0,0 +1,157 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* SSSE3 codec kernels, needs -mssse3 with gcc/clang (see GNUmakefile) */
+
+#include <cstring>
+#include "codec.h"
+#include "cryptopp/misc.h"
+
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+# include <tmmintrin.h>
+#endif
+
+using CryptoPP::word32;
+
+namespace nppcrypt
+{
+namespace codec
+{
+namespace simd
+{
+
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+namespace
+{
+    /* 64 entry lookup: the upper two bits of the 6 bit index select one of four 16 byte tables */
+    inline __m128i lookup64(__m128i index, const __m128i* table)
+    {
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(index, 4), _mm_set1_epi8(0x0f));
+        __m128i r = _mm_setzero_si128();
+        for (int k = 0; k < 4; k++) {
+            r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(hi, _mm_set1_epi8((char)k)), _mm_shuffle_epi8(table[k], index)));
+        }
+        return r;
+    }
+
+    /* 128 entry lookup, bytes >= 128 (and invalid entries) have the high bit set */
+    inline __m128i lookup128(__m128i c, const __m128i* table)
+    {
+        const __m128i hi = _mm_and_si128(_mm_srli_epi16(c, 4), _mm_set1_epi8(0x0f));
+        __m128i r = _mm_and_si128(c, _mm_set1_epi8((char)0x80));
+        for (int k = 0; k < 8; k++) {
+            r = _mm_or_si128(r, _mm_and_si128(_mm_cmpeq_epi8(hi, _mm_set1_epi8((char)k)), _mm_shuffle_epi8(table[k], c)));
+        }
+        return r;
+    }
+
+    /* value of hex digits, 0xff for every other character */
+    inline __m128i hexValues(__m128i c)
+    {
+        const __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+        const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+        const __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+        const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+        __m128i r = _mm_or_si128(_mm_and_si128(is_digit, digit), _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+        return _mm_or_si128(r, _mm_andnot_si128(_mm_or_si128(is_digit, is_letter), _mm_set1_epi8((char)0xff)));
+    }
+}
+
+void base16_encode_ssse3(const byte* in, size_t blocks, byte* out, const byte* alphabet)
+{
+    const __m128i table = _mm_loadu_si128((const __m128i*)alphabet);
+    const __m128i nibble = _mm_set1_epi8(0x0f);
+    for (; blocks; blocks--, in += 16, out += 32) {
+        __m128i v = _mm_loadu_si128((const __m128i*)in);
+        __m128i hi = _mm_shuffle_epi8(table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        __m128i lo = _mm_shuffle_epi8(table, _mm_and_si128(v, nibble));
+        _mm_storeu_si128((__m128i*)out, _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128((__m128i*)(out + 16), _mm_unpackhi_epi8(hi, lo));
+    }
+}
+
+size_t base16_decode_ssse3(const byte* in, size_t blocks, byte* out)
+{
+    size_t done = 0;
+    for (; blocks; blocks--, done += 16) {
+        __m128i v = hexValues(_mm_loadu_si128((const __m128i*)(in + done)));
+        word32 invalid = (word32)_mm_movemask_epi8(v);
+        /* pairs of 4 bit values to bytes */
+        v = _mm_maddubs_epi16(v, _mm_set1_epi16(0x0110));
+        v = _mm_packus_epi16(v, v);
+        if (invalid) {
+            /* only the bytes of the valid prefix: the output may end there (see Codec::decode) */
+            size_t valid = CryptoPP::TrailingZeros(invalid) & ~1;
+            byte temp[8];
+            _mm_storel_epi64((__m128i*)temp, v);
+            std::memcpy(out + done / 2, temp, valid / 2);
+            return done + valid;
+        }
+        _mm_storel_epi64((__m128i*)(out + done / 2), v);
+    }
+    return done;
+}
+
+void base64_encode_ssse3(const byte* in, size_t blocks, byte* out, const byte* alphabet)
+{
+    __m128i table[4];
+    for (int k = 0; k < 4; k++) {
+        table[k] = _mm_loadu_si128((const __m128i*)(alphabet + 16 * k));
+    }
+    /* 3 bytes (b0 b1 b2) to the 32 bit word (b1 b0 b2 b1), the four 6 bit indices are then moved into place */
+    const __m128i spread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    for (; blocks; blocks--, in += 12, out += 16) {
+        __m128i v = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)in), spread);
+        __m128i ac = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+        __m128i bd = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+        _mm_storeu_si128((__m128i*)out, lookup64(_mm_or_si128(ac, bd), table));
+    }
+}
+
+size_t base64_decode_ssse3(const byte* in, size_t blocks, byte* out, const byte* tables)
+{
+    __m128i table[8];
+    for (int k = 0; k < 8; k++) {
+        table[k] = _mm_loadu_si128((const __m128i*)(tables + 16 * k));
+    }
+    const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    size_t done = 0;
+    for (; blocks; blocks--, done += 16) {
+        __m128i v = lookup128(_mm_loadu_si128((const __m128i*)(in + done)), table);
+        word32 invalid = (word32)_mm_movemask_epi8(v);
+        /* four 6 bit values to 24 bits per 32 bit word */
+        v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+        v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+        v = _mm_shuffle_epi8(v, pack);
+        byte* o = out + done / 4 * 3;
+        if (invalid) {
+            /* the groups in front of the invalid character are valid */
+            size_t valid = CryptoPP::TrailingZeros(invalid) & ~3;
+            byte temp[16];
+            _mm_storeu_si128((__m128i*)temp, v);
+            std::memcpy(o, temp, valid / 4 * 3);
+            return done + valid;
+        }
+        _mm_storel_epi64((__m128i*)o, v);
+        word32 w = (word32)_mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+        std::memcpy(o + 8, &w, 4);
+    }
+    return done;
+}
+#endif
+
+};
+};
+};
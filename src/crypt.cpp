@@ -14,7 +14,17 @@ GNU General Public License for more details.
 */
 
 #include <sstream>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <exception>
 #include "crypt.h"
+#include "parallelhash.h"
+#include "keccakx2.h"
+#include "checksum.h"
+#include "multibuffer.h"
+#include "xxh3.h"
+#include "codec.h"
 
 #include "bcrypt/crypt_blowfish.h"
 #include "keccak/KeccakHash.h"
@@ -67,7 +77,6 @@ extern "C" {
 #include "cryptopp/chacha.h"
 #include "cryptopp/panama.h"
 #include "cryptopp/eax.h"
-#include "cryptopp/files.h"
 #include "cryptopp/scrypt.h"
 #include "cryptopp/3way.h"
 #include "cryptopp/aria.h"
@@ -185,616 +194,142 @@ namespace intern
             return new PKCS5_PBKDF2_HMAC< Tiger >;
         case Hash::whirlpool:
             return new PKCS5_PBKDF2_HMAC< Whirlpool >;
+        case Hash::crc32c:
+        case Hash::parallelhash128:
+        case Hash::parallelhash256:
+        case Hash::xxh3:
+            break;
         }
         return NULL;
     }
 
-    CryptoPP::AuthenticatedSymmetricCipher* getAuthenticatedCipher(Cipher cipher, Mode mode, bool encryption)
+    /* table driven cipher factories: one entry per Cipher (in enum order) with the factories of its modes and its key, iv and block sizes.
+       Lookup is an index into the table, every Mode<Cipher> template is instantiated by the generic factories below */
+    namespace registry
     {
         using namespace CryptoPP;
-        switch (cipher)
-        {
-        case Cipher::aria:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< ARIA >::Encryption) : (new GCM< ARIA >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< ARIA >::Encryption) : (new CCM< ARIA >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< ARIA >::Encryption) : (new EAX< ARIA >::Decryption));
-            }
-            break;
-        }
-        case Cipher::camellia:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< Camellia >::Encryption) : (new GCM< Camellia >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< Camellia >::Encryption) : (new CCM< Camellia >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< Camellia >::Encryption) : (new EAX< Camellia >::Decryption));
-            }
-            break;
-        }
-        case Cipher::cast256:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< CAST256 >::Encryption) : (new GCM< CAST256 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< CAST256 >::Encryption) : (new CCM< CAST256 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< CAST256 >::Encryption) : (new EAX< CAST256 >::Decryption));
-            }
-            break;
-        }
-        case Cipher::kalyna128:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< Kalyna128 >::Encryption) : (new GCM< Kalyna128 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< Kalyna128 >::Encryption) : (new CCM< Kalyna128 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< Kalyna128 >::Encryption) : (new EAX< Kalyna128 >::Decryption));
-            }
-            break;
-        }
-        case Cipher::mars:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< MARS >::Encryption) : (new GCM< MARS >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< MARS >::Encryption) : (new CCM< MARS >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< MARS >::Encryption) : (new EAX< MARS >::Decryption));
-            }
-            break;
-        }
-        case Cipher::rc6:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< RC6 >::Encryption) : (new GCM< RC6 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< RC6 >::Encryption) : (new CCM< RC6 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< RC6 >::Encryption) : (new EAX< RC6 >::Decryption));
-            }
-            break;
-        }
-        case Cipher::rijndael:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< AES >::Encryption) : (new GCM< AES >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< AES >::Encryption) : (new CCM< AES >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< AES >::Encryption) : (new EAX< AES >::Decryption));
-            }
-            break;
-        }
-        case Cipher::seed:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< SEED >::Encryption) : (new GCM< SEED >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< SEED >::Encryption) : (new CCM< SEED >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< SEED >::Encryption) : (new EAX< SEED >::Decryption));
-            }
-            break;
-        }
-        case Cipher::serpent:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< Serpent >::Encryption) : (new GCM< Serpent >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< Serpent >::Encryption) : (new CCM< Serpent >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< Serpent >::Encryption) : (new EAX< Serpent >::Decryption));
-            }
-            break;
-        }
-        case Cipher::simon128:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< SIMON128 >::Encryption) : (new GCM< SIMON128 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< SIMON128 >::Encryption) : (new CCM< SIMON128 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< SIMON128 >::Encryption) : (new EAX< SIMON128 >::Decryption));
-            }
-            break;
-        }
-        case Cipher::sm4:
-        {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< SM4 >::Encryption) : (new GCM< SM4 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< SM4 >::Encryption) : (new CCM< SM4 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< SM4 >::Encryption) : (new EAX< SM4 >::Decryption));
-            }
-            break;
-        }
-        case Cipher::speck128:
+
+        template<class T> SymmetricCipher* blockModes(Mode mode, bool encryption)
         {
             switch (mode)
             {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< SPECK128 >::Encryption) : (new GCM< SPECK128 >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< SPECK128 >::Encryption) : (new CCM< SPECK128 >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< SPECK128 >::Encryption) : (new EAX< SPECK128 >::Decryption));
+            case Mode::ecb: return encryption ? (SymmetricCipher*)(new typename ECB_Mode<T>::Encryption) : (new typename ECB_Mode<T>::Decryption);
+            case Mode::cbc: return encryption ? (SymmetricCipher*)(new typename CBC_Mode<T>::Encryption) : (new typename CBC_Mode<T>::Decryption);
+            case Mode::cfb: return encryption ? (SymmetricCipher*)(new typename CFB_Mode<T>::Encryption) : (new typename CFB_Mode<T>::Decryption);
+            case Mode::ofb: return encryption ? (SymmetricCipher*)(new typename OFB_Mode<T>::Encryption) : (new typename OFB_Mode<T>::Decryption);
+            case Mode::ctr: return encryption ? (SymmetricCipher*)(new typename CTR_Mode<T>::Encryption) : (new typename CTR_Mode<T>::Decryption);
+            default: return NULL;
             }
-            break;
         }
-        case Cipher::square:
+
+        /* stream ciphers ignore the mode */
+        template<class T> SymmetricCipher* streamCipher(Mode, bool encryption)
         {
-            switch (mode)
-            {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< Square >::Encryption) : (new GCM< Square >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< Square >::Encryption) : (new CCM< Square >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< Square >::Encryption) : (new EAX< Square >::Decryption));
-            }
-            break;
+            return encryption ? (SymmetricCipher*)(new typename T::Encryption) : (new typename T::Decryption);
         }
-        case Cipher::twofish:
+
+        /* 128 bit block ciphers */
+        template<class T> AuthenticatedSymmetricCipher* authenticatedModes(Mode mode, bool encryption)
         {
             switch (mode)
             {
-            case Mode::gcm: return (encryption ? (AuthenticatedSymmetricCipher*)(new GCM< Twofish >::Encryption) : (new GCM< Twofish >::Decryption));
-            case Mode::ccm: return (encryption ? (AuthenticatedSymmetricCipher*)(new CCM< Twofish >::Encryption) : (new CCM< Twofish >::Decryption));
-            case Mode::eax: return (encryption ? (AuthenticatedSymmetricCipher*)(new EAX< Twofish >::Encryption) : (new EAX< Twofish >::Decryption));
-            }
-            break;
-        }
+            case Mode::gcm: return encryption ? (AuthenticatedSymmetricCipher*)(new typename GCM<T>::Encryption) : (new typename GCM<T>::Decryption);
+            case Mode::ccm: return encryption ? (AuthenticatedSymmetricCipher*)(new typename CCM<T>::Encryption) : (new typename CCM<T>::Decryption);
+            case Mode::eax: return encryption ? (AuthenticatedSymmetricCipher*)(new typename EAX<T>::Encryption) : (new typename EAX<T>::Decryption);
+            default: return NULL;
+            }
+        }
+
+        /* valid key length closest to length, 0: the default */
+        template<class T, size_t D = T::DEFAULT_KEYLENGTH> size_t variableKey(size_t length)
+        {
+            return (length == 0) ? D : T::StaticGetValidKeyLength(length);
+        }
+
+        template<size_t N> size_t fixedKey(size_t)
+        {
+            return N;
+        }
+
+        struct CipherEntry
+        {
+            SymmetricCipher*                (*symmetric)(Mode mode, bool encryption);
+            AuthenticatedSymmetricCipher*   (*authenticated)(Mode mode, bool encryption);
+            size_t                          (*keyLength)(size_t length);
+            size_t                          block_size;     /* 0: stream cipher */
+            size_t                          iv_length;      /* of the block modes but ecb and ccm ( see getCipherInfo() ) */
+        };
+
+        typedef PanamaCipher<LittleEndian>  Panama;
+        typedef SEAL<LittleEndian>          Seal;
+        typedef WAKE_OFB<LittleEndian>      Wake;
+
+        const CipherEntry ciphers[] =
+        {
+            /* threeway         */ { blockModes<ThreeWay>, NULL, fixedKey<ThreeWay::KEYLENGTH>, ThreeWay::BLOCKSIZE, ThreeWay::BLOCKSIZE },
+            /* aria             */ { blockModes<ARIA>, authenticatedModes<ARIA>, variableKey<ARIA>, ARIA::BLOCKSIZE, ARIA::BLOCKSIZE },
+            /* blowfish         */ { blockModes<Blowfish>, NULL, variableKey<Blowfish>, Blowfish::BLOCKSIZE, Blowfish::BLOCKSIZE },
+            /* camellia         */ { blockModes<Camellia>, authenticatedModes<Camellia>, variableKey<Camellia>, Camellia::BLOCKSIZE, Camellia::BLOCKSIZE },
+            /* cast128          */ { blockModes<CAST128>, NULL, variableKey<CAST128>, CAST128::BLOCKSIZE, CAST128::BLOCKSIZE },
+            /* cast256          */ { blockModes<CAST256>, authenticatedModes<CAST256>, variableKey<CAST256>, CAST256::BLOCKSIZE, CAST256::BLOCKSIZE },
+            /* chacha20         */ { streamCipher<ChaCha>, NULL, variableKey<ChaCha>, 0, ChaCha::IV_LENGTH },
+            /* des              */ { blockModes<DES>, NULL, fixedKey<DES::KEYLENGTH>, DES::BLOCKSIZE, DES::BLOCKSIZE },
+            /* des_ede2         */ { blockModes<DES_EDE2>, NULL, fixedKey<DES_EDE2::KEYLENGTH>, DES_EDE2::BLOCKSIZE, DES_EDE2::BLOCKSIZE },
+            /* des_ede3         */ { blockModes<DES_EDE3>, NULL, fixedKey<DES_EDE3::KEYLENGTH>, DES_EDE3::BLOCKSIZE, DES_EDE3::BLOCKSIZE },
+            /* desx             */ { blockModes<DES_XEX3>, NULL, fixedKey<DES_XEX3::KEYLENGTH>, DES_XEX3::BLOCKSIZE, DES_XEX3::BLOCKSIZE },
+            /* gost             */ { blockModes<GOST>, NULL, fixedKey<GOST::KEYLENGTH>, GOST::BLOCKSIZE, GOST::BLOCKSIZE },
+            /* idea             */ { blockModes<IDEA>, NULL, fixedKey<IDEA::KEYLENGTH>, IDEA::BLOCKSIZE, IDEA::BLOCKSIZE },
+            /* kalyna128        */ { blockModes<Kalyna128>, authenticatedModes<Kalyna128>, variableKey<Kalyna128>, Kalyna128::BLOCKSIZE, Kalyna128::BLOCKSIZE },
+            /* kalyna256        */ { blockModes<Kalyna256>, NULL, variableKey<Kalyna256>, Kalyna256::BLOCKSIZE, Kalyna256::BLOCKSIZE },
+            /* kalyna512        */ { blockModes<Kalyna512>, NULL, fixedKey<64>, 64, 64 },
+            /* mars             */ { blockModes<MARS>, authenticatedModes<MARS>, variableKey<MARS>, MARS::BLOCKSIZE, MARS::BLOCKSIZE },
+            /* panama           */ { streamCipher<Panama>, NULL, fixedKey<Panama::KEYLENGTH>, 0, Panama::IV_LENGTH },
+            /* rc2              */ { blockModes<RC2>, NULL, variableKey<RC2>, RC2::BLOCKSIZE, RC2::BLOCKSIZE },
+            /* rc4              */ { streamCipher<Weak::ARC4>, NULL, variableKey<Weak::ARC4>, 0, 0 },
+            /* rc5              */ { blockModes<RC5>, NULL, variableKey<RC5>, RC5::BLOCKSIZE, RC5::BLOCKSIZE },
+            /* rc6              */ { blockModes<RC6>, authenticatedModes<RC6>, variableKey<RC6>, RC6::BLOCKSIZE, RC6::BLOCKSIZE },
+            /* rijndael         */ { blockModes<AES>, authenticatedModes<AES>, variableKey<AES, 32>, AES::BLOCKSIZE, AES::BLOCKSIZE },
+            /* saferk           */ { blockModes<SAFER_K>, NULL, variableKey<SAFER_K>, SAFER_K::BLOCKSIZE, SAFER_K::BLOCKSIZE },
+            /* safersk          */ { blockModes<SAFER_SK>, NULL, variableKey<SAFER_SK>, SAFER_SK::BLOCKSIZE, SAFER_SK::BLOCKSIZE },
+            /* salsa20          */ { streamCipher<Salsa20>, NULL, variableKey<Salsa20>, 0, Salsa20::IV_LENGTH },
+            /* seal             */ { streamCipher<Seal>, NULL, fixedKey<Seal::KEYLENGTH>, 0, Seal::IV_LENGTH },
+            /* seed             */ { blockModes<SEED>, authenticatedModes<SEED>, fixedKey<SEED::KEYLENGTH>, SEED::BLOCKSIZE, SEED::BLOCKSIZE },
+            /* serpent          */ { blockModes<Serpent>, authenticatedModes<Serpent>, variableKey<Serpent>, Serpent::BLOCKSIZE, Serpent::BLOCKSIZE },
+            /* shacal2          */ { blockModes<SHACAL2>, NULL, variableKey<SHACAL2>, SHACAL2::BLOCKSIZE, SHACAL2::BLOCKSIZE },
+            /* shark            */ { blockModes<SHARK>, NULL, fixedKey<SHARK::KEYLENGTH>, SHARK::BLOCKSIZE, SHARK::BLOCKSIZE },
+            /* simon128         */ { blockModes<SIMON128>, authenticatedModes<SIMON128>, variableKey<SIMON128>, SIMON128::BLOCKSIZE, SIMON128::BLOCKSIZE },
+            /* skipjack         */ { blockModes<SKIPJACK>, NULL, fixedKey<SKIPJACK::KEYLENGTH>, SKIPJACK::BLOCKSIZE, SKIPJACK::BLOCKSIZE },
+            /* sm4              */ { blockModes<SM4>, authenticatedModes<SM4>, fixedKey<SM4::KEYLENGTH>, SM4::BLOCKSIZE, SM4::BLOCKSIZE },
+            /* sosemanuk        */ { streamCipher<Sosemanuk>, NULL, variableKey<Sosemanuk>, 0, Sosemanuk::IV_LENGTH },
+            /* speck128         */ { blockModes<SPECK128>, authenticatedModes<SPECK128>, variableKey<SPECK128>, SPECK128::BLOCKSIZE, SPECK128::BLOCKSIZE },
+            /* square           */ { blockModes<Square>, authenticatedModes<Square>, fixedKey<Square::KEYLENGTH>, Square::BLOCKSIZE, Square::BLOCKSIZE },
+            /* tea              */ { blockModes<TEA>, NULL, fixedKey<TEA::KEYLENGTH>, TEA::BLOCKSIZE, TEA::BLOCKSIZE },
+            /* threefish256     */ { blockModes<Threefish256>, NULL, fixedKey<Threefish256::KEYLENGTH>, Threefish256::BLOCKSIZE, Threefish256::BLOCKSIZE },
+            /* threefish512     */ { blockModes<Threefish512>, NULL, fixedKey<64>, 64, 64 },
+            /* threefish1024    */ { blockModes<Threefish1024>, NULL, fixedKey<128>, 128, 128 },
+            /* twofish          */ { blockModes<Twofish>, authenticatedModes<Twofish>, variableKey<Twofish>, Twofish::BLOCKSIZE, Twofish::BLOCKSIZE },
+            /* wake             */ { streamCipher<Wake>, NULL, fixedKey<Wake::KEYLENGTH>, 0, 0 },
+            /* xsalsa20         */ { streamCipher<XSalsa20>, NULL, fixedKey<XSalsa20::KEYLENGTH>, 0, XSalsa20::IV_LENGTH },
+            /* xtea             */ { blockModes<XTEA>, NULL, fixedKey<XTEA::KEYLENGTH>, XTEA::BLOCKSIZE, XTEA::BLOCKSIZE },
+        };
+        static_assert(sizeof(ciphers) / sizeof(ciphers[0]) == (size_t)Cipher::COUNT, "one registry entry per cipher");
+
+        const CipherEntry* find(Cipher cipher)
+        {
+            return ((unsigned)cipher < (unsigned)Cipher::COUNT) ? &ciphers[(unsigned)cipher] : NULL;
         }
-        return NULL;
+    }
+
+    CryptoPP::AuthenticatedSymmetricCipher* getAuthenticatedCipher(Cipher cipher, Mode mode, bool encryption)
+    {
+        const registry::CipherEntry* entry = registry::find(cipher);
+        return (entry && entry->authenticated) ? entry->authenticated(mode, encryption) : NULL;
     }
 
     CryptoPP::SymmetricCipher* getSymmetricCipher(Cipher cipher, Mode mode, bool encryption)
     {
-        using namespace CryptoPP;
-        switch (cipher)
-        {
-        case Cipher::threeway:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<ThreeWay>::Encryption) : (new ECB_Mode<ThreeWay>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<ThreeWay>::Encryption) : (new CBC_Mode<ThreeWay>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<ThreeWay>::Encryption) : (new CFB_Mode<ThreeWay>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<ThreeWay>::Encryption) : (new OFB_Mode<ThreeWay>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<ThreeWay>::Encryption) : (new CTR_Mode<ThreeWay>::Decryption);
-            }
-            break;
-        }
-        case Cipher::aria:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<ARIA>::Encryption) : (new ECB_Mode<ARIA>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<ARIA>::Encryption) : (new CBC_Mode<ARIA>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<ARIA>::Encryption) : (new CFB_Mode<ARIA>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<ARIA>::Encryption) : (new OFB_Mode<ARIA>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<ARIA>::Encryption) : (new CTR_Mode<ARIA>::Decryption);
-            }
-            break;
-        }
-        case Cipher::blowfish:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Blowfish>::Encryption) : (new ECB_Mode<Blowfish>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Blowfish>::Encryption) : (new CBC_Mode<Blowfish>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Blowfish>::Encryption) : (new CFB_Mode<Blowfish>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Blowfish>::Encryption) : (new OFB_Mode<Blowfish>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Blowfish>::Encryption) : (new CTR_Mode<Blowfish>::Decryption);
-            }
-            break;
-        }
-        /*case Cipher::btea:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<BTEA>::Encryption) : (new ECB_Mode<BTEA>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<BTEA>::Encryption) : (new CBC_Mode<BTEA>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<BTEA>::Encryption) : (new CFB_Mode<BTEA>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<BTEA>::Encryption) : (new OFB_Mode<BTEA>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<BTEA>::Encryption) : (new CTR_Mode<BTEA>::Decryption);
-            }
-            break;
-        }*/
-        case Cipher::camellia:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Camellia>::Encryption) : (new ECB_Mode<Camellia>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Camellia>::Encryption) : (new CBC_Mode<Camellia>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Camellia>::Encryption) : (new CFB_Mode<Camellia>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Camellia>::Encryption) : (new OFB_Mode<Camellia>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Camellia>::Encryption) : (new CTR_Mode<Camellia>::Decryption);
-            }
-            break;
-        }
-        case Cipher::cast128:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<CAST128>::Encryption) : (new ECB_Mode<CAST128>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<CAST128>::Encryption) : (new CBC_Mode<CAST128>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<CAST128>::Encryption) : (new CFB_Mode<CAST128>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<CAST128>::Encryption) : (new OFB_Mode<CAST128>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<CAST128>::Encryption) : (new CTR_Mode<CAST128>::Decryption);
-            }
-            break;
-        }
-        case Cipher::cast256:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<CAST256>::Encryption) : (new ECB_Mode<CAST256>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<CAST256>::Encryption) : (new CBC_Mode<CAST256>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<CAST256>::Encryption) : (new CFB_Mode<CAST256>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<CAST256>::Encryption) : (new OFB_Mode<CAST256>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<CAST256>::Encryption) : (new CTR_Mode<CAST256>::Decryption);
-            }
-            break;
-        }
-        case Cipher::des:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<DES>::Encryption) : (new ECB_Mode<DES>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<DES>::Encryption) : (new CBC_Mode<DES>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<DES>::Encryption) : (new CFB_Mode<DES>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<DES>::Encryption) : (new OFB_Mode<DES>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<DES>::Encryption) : (new CTR_Mode<DES>::Decryption);
-            }
-            break;
-        }
-        case Cipher::des_ede2:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<DES_EDE2>::Encryption) : (new ECB_Mode<DES_EDE2>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<DES_EDE2>::Encryption) : (new CBC_Mode<DES_EDE2>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<DES_EDE2>::Encryption) : (new CFB_Mode<DES_EDE2>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<DES_EDE2>::Encryption) : (new OFB_Mode<DES_EDE2>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<DES_EDE2>::Encryption) : (new CTR_Mode<DES_EDE2>::Decryption);
-            }
-            break;
-        }
-        case Cipher::des_ede3:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<DES_EDE3>::Encryption) : (new ECB_Mode<DES_EDE3>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<DES_EDE3>::Encryption) : (new CBC_Mode<DES_EDE3>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<DES_EDE3>::Encryption) : (new CFB_Mode<DES_EDE3>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<DES_EDE3>::Encryption) : (new OFB_Mode<DES_EDE3>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<DES_EDE3>::Encryption) : (new CTR_Mode<DES_EDE3>::Decryption);
-            }
-            break;
-        }
-        case Cipher::desx:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<DES_XEX3>::Encryption) : (new ECB_Mode<DES_XEX3>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<DES_XEX3>::Encryption) : (new CBC_Mode<DES_XEX3>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<DES_XEX3>::Encryption) : (new CFB_Mode<DES_XEX3>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<DES_XEX3>::Encryption) : (new OFB_Mode<DES_XEX3>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<DES_XEX3>::Encryption) : (new CTR_Mode<DES_XEX3>::Decryption);
-            }
-            break;
-        }
-        case Cipher::gost:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<GOST>::Encryption) : (new ECB_Mode<GOST>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<GOST>::Encryption) : (new CBC_Mode<GOST>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<GOST>::Encryption) : (new CFB_Mode<GOST>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<GOST>::Encryption) : (new OFB_Mode<GOST>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<GOST>::Encryption) : (new CTR_Mode<GOST>::Decryption);
-            }
-            break;
-        }
-        case Cipher::idea:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<IDEA>::Encryption) : (new ECB_Mode<IDEA>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<IDEA>::Encryption) : (new CBC_Mode<IDEA>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<IDEA>::Encryption) : (new CFB_Mode<IDEA>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<IDEA>::Encryption) : (new OFB_Mode<IDEA>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<IDEA>::Encryption) : (new CTR_Mode<IDEA>::Decryption);
-            }
-            break;
-        }
-        case Cipher::kalyna128:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Kalyna128>::Encryption) : (new ECB_Mode<Kalyna128>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Kalyna128>::Encryption) : (new CBC_Mode<Kalyna128>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Kalyna128>::Encryption) : (new CFB_Mode<Kalyna128>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Kalyna128>::Encryption) : (new OFB_Mode<Kalyna128>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Kalyna128>::Encryption) : (new CTR_Mode<Kalyna128>::Decryption);
-            }
-            break;
-        }
-        case Cipher::kalyna256:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Kalyna256>::Encryption) : (new ECB_Mode<Kalyna256>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Kalyna256>::Encryption) : (new CBC_Mode<Kalyna256>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Kalyna256>::Encryption) : (new CFB_Mode<Kalyna256>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Kalyna256>::Encryption) : (new OFB_Mode<Kalyna256>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Kalyna256>::Encryption) : (new CTR_Mode<Kalyna256>::Decryption);
-            }
-            break;
-        }
-        case Cipher::kalyna512:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Kalyna512>::Encryption) : (new ECB_Mode<Kalyna512>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Kalyna512>::Encryption) : (new CBC_Mode<Kalyna512>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Kalyna512>::Encryption) : (new CFB_Mode<Kalyna512>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Kalyna512>::Encryption) : (new OFB_Mode<Kalyna512>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Kalyna512>::Encryption) : (new CTR_Mode<Kalyna512>::Decryption);
-            }
-            break;
-        }
-        case Cipher::mars:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<MARS>::Encryption) : (new ECB_Mode<MARS>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<MARS>::Encryption) : (new CBC_Mode<MARS>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<MARS>::Encryption) : (new CFB_Mode<MARS>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<MARS>::Encryption) : (new OFB_Mode<MARS>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<MARS>::Encryption) : (new CTR_Mode<MARS>::Decryption);
-            }
-            break;
-        }
-        case Cipher::rc2:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<RC2>::Encryption) : (new ECB_Mode<RC2>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<RC2>::Encryption) : (new CBC_Mode<RC2>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<RC2>::Encryption) : (new CFB_Mode<RC2>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<RC2>::Encryption) : (new OFB_Mode<RC2>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<RC2>::Encryption) : (new CTR_Mode<RC2>::Decryption);
-            }
-            break;
-        }
-        case Cipher::rc5:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<RC5>::Encryption) : (new ECB_Mode<RC5>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<RC5>::Encryption) : (new CBC_Mode<RC5>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<RC5>::Encryption) : (new CFB_Mode<RC5>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<RC5>::Encryption) : (new OFB_Mode<RC5>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<RC5>::Encryption) : (new CTR_Mode<RC5>::Decryption);
-            }
-            break;
-        }
-        case Cipher::rc6:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<RC6>::Encryption) : (new ECB_Mode<RC6>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<RC6>::Encryption) : (new CBC_Mode<RC6>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<RC6>::Encryption) : (new CFB_Mode<RC6>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<RC6>::Encryption) : (new OFB_Mode<RC6>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<RC6>::Encryption) : (new CTR_Mode<RC6>::Decryption);
-            }
-            break;
-        }
-        case Cipher::rijndael:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<AES>::Encryption) : (new ECB_Mode<AES>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<AES>::Encryption) : (new CBC_Mode<AES>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<AES>::Encryption) : (new CFB_Mode<AES>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<AES>::Encryption) : (new OFB_Mode<AES>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<AES>::Encryption) : (new CTR_Mode<AES>::Decryption);
-            }
-            break;
-        }
-        case Cipher::saferk:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SAFER_K>::Encryption) : (new ECB_Mode<SAFER_K>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SAFER_K>::Encryption) : (new CBC_Mode<SAFER_K>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SAFER_K>::Encryption) : (new CFB_Mode<SAFER_K>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SAFER_K>::Encryption) : (new OFB_Mode<SAFER_K>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SAFER_K>::Encryption) : (new CTR_Mode<SAFER_K>::Decryption);
-            }
-            break;
-        }
-        case Cipher::safersk:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SAFER_SK>::Encryption) : (new ECB_Mode<SAFER_SK>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SAFER_SK>::Encryption) : (new CBC_Mode<SAFER_SK>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SAFER_SK>::Encryption) : (new CFB_Mode<SAFER_SK>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SAFER_SK>::Encryption) : (new OFB_Mode<SAFER_SK>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SAFER_SK>::Encryption) : (new CTR_Mode<SAFER_SK>::Decryption);
-            }
-            break;
-        }
-        case Cipher::seed:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SEED>::Encryption) : (new ECB_Mode<SEED>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SEED>::Encryption) : (new CBC_Mode<SEED>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SEED>::Encryption) : (new CFB_Mode<SEED>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SEED>::Encryption) : (new OFB_Mode<SEED>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SEED>::Encryption) : (new CTR_Mode<SEED>::Decryption);
-            }
-            break;
-        }
-        case Cipher::serpent:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Serpent>::Encryption) : (new ECB_Mode<Serpent>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Serpent>::Encryption) : (new CBC_Mode<Serpent>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Serpent>::Encryption) : (new CFB_Mode<Serpent>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Serpent>::Encryption) : (new OFB_Mode<Serpent>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Serpent>::Encryption) : (new CTR_Mode<Serpent>::Decryption);
-            }
-            break;
-        }
-        case Cipher::shacal2:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SHACAL2>::Encryption) : (new ECB_Mode<SHACAL2>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SHACAL2>::Encryption) : (new CBC_Mode<SHACAL2>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SHACAL2>::Encryption) : (new CFB_Mode<SHACAL2>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SHACAL2>::Encryption) : (new OFB_Mode<SHACAL2>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SHACAL2>::Encryption) : (new CTR_Mode<SHACAL2>::Decryption);
-            }
-            break;
-        }
-        case Cipher::shark:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SHARK>::Encryption) : (new ECB_Mode<SHARK>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SHARK>::Encryption) : (new CBC_Mode<SHARK>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SHARK>::Encryption) : (new CFB_Mode<SHARK>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SHARK>::Encryption) : (new OFB_Mode<SHARK>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SHARK>::Encryption) : (new CTR_Mode<SHARK>::Decryption);
-            }
-            break;
-        }
-        case Cipher::simon128:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SIMON128>::Encryption) : (new ECB_Mode<SIMON128>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SIMON128>::Encryption) : (new CBC_Mode<SIMON128>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SIMON128>::Encryption) : (new CFB_Mode<SIMON128>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SIMON128>::Encryption) : (new OFB_Mode<SIMON128>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SIMON128>::Encryption) : (new CTR_Mode<SIMON128>::Decryption);
-            }
-            break;
-        }
-        case Cipher::skipjack:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SKIPJACK>::Encryption) : (new ECB_Mode<SKIPJACK>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SKIPJACK>::Encryption) : (new CBC_Mode<SKIPJACK>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SKIPJACK>::Encryption) : (new CFB_Mode<SKIPJACK>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SKIPJACK>::Encryption) : (new OFB_Mode<SKIPJACK>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SKIPJACK>::Encryption) : (new CTR_Mode<SKIPJACK>::Decryption);
-            }
-            break;
-        }
-        case Cipher::sm4:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SM4>::Encryption) : (new ECB_Mode<SM4>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SM4>::Encryption) : (new CBC_Mode<SM4>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SM4>::Encryption) : (new CFB_Mode<SM4>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SM4>::Encryption) : (new OFB_Mode<SM4>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SM4>::Encryption) : (new CTR_Mode<SM4>::Decryption);
-            }
-            break;
-        }
-        case Cipher::speck128:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<SPECK128>::Encryption) : (new ECB_Mode<SPECK128>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<SPECK128>::Encryption) : (new CBC_Mode<SPECK128>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<SPECK128>::Encryption) : (new CFB_Mode<SPECK128>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<SPECK128>::Encryption) : (new OFB_Mode<SPECK128>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<SPECK128>::Encryption) : (new CTR_Mode<SPECK128>::Decryption);
-            }
-            break;
-        }
-        case Cipher::square:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Square>::Encryption) : (new ECB_Mode<Square>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Square>::Encryption) : (new CBC_Mode<Square>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Square>::Encryption) : (new CFB_Mode<Square>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Square>::Encryption) : (new OFB_Mode<Square>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Square>::Encryption) : (new CTR_Mode<Square>::Decryption);
-            }
-            break;
-        }
-        case Cipher::tea:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<TEA>::Encryption) : (new ECB_Mode<TEA>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<TEA>::Encryption) : (new CBC_Mode<TEA>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<TEA>::Encryption) : (new CFB_Mode<TEA>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<TEA>::Encryption) : (new OFB_Mode<TEA>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<TEA>::Encryption) : (new CTR_Mode<TEA>::Decryption);
-            }
-            break;
-        }
-        case Cipher::threefish256:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Threefish256>::Encryption) : (new ECB_Mode<Threefish256>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Threefish256>::Encryption) : (new CBC_Mode<Threefish256>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Threefish256>::Encryption) : (new CFB_Mode<Threefish256>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Threefish256>::Encryption) : (new OFB_Mode<Threefish256>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Threefish256>::Encryption) : (new CTR_Mode<Threefish256>::Decryption);
-            }
-            break;
-        }
-        case Cipher::threefish512:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Threefish512>::Encryption) : (new ECB_Mode<Threefish512>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Threefish512>::Encryption) : (new CBC_Mode<Threefish512>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Threefish512>::Encryption) : (new CFB_Mode<Threefish512>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Threefish512>::Encryption) : (new OFB_Mode<Threefish512>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Threefish512>::Encryption) : (new CTR_Mode<Threefish512>::Decryption);
-            }
-            break;
-        }
-        case Cipher::threefish1024:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Threefish1024>::Encryption) : (new ECB_Mode<Threefish1024>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Threefish1024>::Encryption) : (new CBC_Mode<Threefish1024>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Threefish1024>::Encryption) : (new CFB_Mode<Threefish1024>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Threefish1024>::Encryption) : (new OFB_Mode<Threefish1024>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Threefish1024>::Encryption) : (new CTR_Mode<Threefish1024>::Decryption);
-            }
-            break;
-        }
-        case Cipher::twofish:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<Twofish>::Encryption) : (new ECB_Mode<Twofish>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<Twofish>::Encryption) : (new CBC_Mode<Twofish>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<Twofish>::Encryption) : (new CFB_Mode<Twofish>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<Twofish>::Encryption) : (new OFB_Mode<Twofish>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<Twofish>::Encryption) : (new CTR_Mode<Twofish>::Decryption);
-            }
-            break;
-        }
-        case Cipher::xtea:
-        {
-            switch (mode) {
-            case Mode::ecb: return encryption ? (SymmetricCipher*)(new ECB_Mode<XTEA>::Encryption) : (new ECB_Mode<XTEA>::Decryption);
-            case Mode::cbc: return encryption ? (SymmetricCipher*)(new CBC_Mode<XTEA>::Encryption) : (new CBC_Mode<XTEA>::Decryption);
-            case Mode::cfb: return encryption ? (SymmetricCipher*)(new CFB_Mode<XTEA>::Encryption) : (new CFB_Mode<XTEA>::Decryption);
-            case Mode::ofb: return encryption ? (SymmetricCipher*)(new OFB_Mode<XTEA>::Encryption) : (new OFB_Mode<XTEA>::Decryption);
-            case Mode::ctr: return encryption ? (SymmetricCipher*)(new CTR_Mode<XTEA>::Encryption) : (new CTR_Mode<XTEA>::Decryption);
-            }
-            break;
-        }
-        case Cipher::sosemanuk:
-        {
-            return encryption ? (SymmetricCipher*)(new Sosemanuk::Encryption) : (new Sosemanuk::Decryption);
-        }
-        case Cipher::rc4:
-        {
-            return encryption ? (SymmetricCipher*)(new Weak::ARC4::Encryption) : (new Weak::ARC4::Decryption);
-        }
-        case Cipher::salsa20:
-        {
-            return encryption ? (SymmetricCipher*)(new Salsa20::Encryption) : (new Salsa20::Decryption);
-        }
-        case Cipher::xsalsa20:
-        {
-            return encryption ? (SymmetricCipher*)(new XSalsa20::Encryption) : (new XSalsa20::Decryption);
-        }
-        case Cipher::chacha20:
-        {
-            return encryption ? (SymmetricCipher*)(new ChaCha::Encryption) : (new ChaCha::Decryption);
-        }
-        case Cipher::panama:
-        {
-            return encryption ? (SymmetricCipher*)(new PanamaCipher<LittleEndian>::Encryption) : (new PanamaCipher<LittleEndian>::Decryption);
-        }
-        case Cipher::wake:
-        {
-            return encryption ? (SymmetricCipher*)(new WAKE_OFB<LittleEndian>::Encryption) : (new WAKE_OFB<LittleEndian>::Decryption);
-        }
-        case Cipher::seal:
-        {
-            return encryption ? (SymmetricCipher*)(new SEAL<LittleEndian>::Encryption) : (new SEAL<LittleEndian>::Decryption);
-        }
-        }
-        return NULL;
+        const registry::CipherEntry* entry = registry::find(cipher);
+        return entry ? entry->symmetric(mode, encryption) : NULL;
     }
 
     CryptoPP::HashTransformation* getHashTransformation(nppcrypt::Options::Hash options)
@@ -946,12 +481,20 @@ namespace intern
                 options.digest_length = 64;
                 return new HMAC<Whirlpool>(options.key.BytePtr(), options.key.size());
             }
+            case Hash::crc32c:
+            case Hash::parallelhash128:
+            case Hash::parallelhash256:
+            case Hash::xxh3:
+                break;
             }
         } else {
             switch (options.algorithm) {
             case Hash::adler32:
             {
                 options.digest_length = 4;
+                if (Checksum::accelerated(Checksum::Type::adler32)) {
+                    return new Checksum(Checksum::Type::adler32);
+                }
                 return new Adler32;
             }
             case Hash::blake2b:
@@ -973,8 +516,19 @@ namespace intern
             case Hash::crc32:
             {
                 options.digest_length = 4;
+                if (Checksum::accelerated(Checksum::Type::crc32)) {
+                    return new Checksum(Checksum::Type::crc32);
+                }
                 return new CRC32;
             }
+            case Hash::crc32c:
+            {
+                options.digest_length = 4;
+                if (Checksum::accelerated(Checksum::Type::crc32c)) {
+                    return new Checksum(Checksum::Type::crc32c);
+                }
+                return new CRC32C;
+            }
             case Hash::keccak:
             {
                 if (options.digest_length == 28) {
@@ -1006,6 +560,20 @@ namespace intern
                 options.digest_length = 16;
                 return new Weak::MD5;
             }
+            case Hash::parallelhash128:
+            {
+                if (options.digest_length != 16 && options.digest_length != 32 && options.digest_length != 48 && options.digest_length != 64) {
+                    options.digest_length = 32;
+                }
+                return new ParallelHash(128, (unsigned int)options.digest_length, (const byte*)options.customization.c_str(), options.customization.size());
+            }
+            case Hash::parallelhash256:
+            {
+                if (options.digest_length != 16 && options.digest_length != 32 && options.digest_length != 48 && options.digest_length != 64) {
+                    options.digest_length = 64;
+                }
+                return new ParallelHash(256, (unsigned int)options.digest_length, (const byte*)options.customization.c_str(), options.customization.size());
+            }
             case Hash::ripemd:
             {
                 if (options.digest_length == 16) {
@@ -1074,12 +642,265 @@ namespace intern
                 options.digest_length = 64;
                 return new Whirlpool;
             }
+            case Hash::xxh3:
+            {
+                if (options.digest_length != 16) {
+                    options.digest_length = 8;
+                }
+                return new nppcrypt::XXH3((unsigned int)options.digest_length);
+            }
             }
         }
         return NULL;
     }
 
-    void calcKey(CryptoPP::SecByteBlock& key, const UserData& password, const UserData& salt, const nppcrypt::Options::Crypt::Key& opt)
+    /* md5, sha1 and sha2-256 without key can be hashed by the multi-buffer engine */
+    bool getMultiBufferAlgorithm(const nppcrypt::Options::Hash& options, multibuffer::Algorithm& algorithm)
+    {
+        if (options.use_key || !multibuffer::accelerated()) {
+            return false;
+        }
+        switch (options.algorithm)
+        {
+        case Hash::md5: algorithm = multibuffer::Algorithm::md5; return true;
+        case Hash::sha1: algorithm = multibuffer::Algorithm::sha1; return true;
+        case Hash::sha2:
+            if (options.digest_length == 32) {
+                algorithm = multibuffer::Algorithm::sha256;
+                return true;
+            }
+            return false;
+        default:
+            return false;
+        }
+    }
+
+    /* files are opened when a lane of the multi-buffer engine takes them */
+    class MultiBufferFiles : public multibuffer::Source
+    {
+    public:
+        MultiBufferFiles(const std::vector<std::string>& paths) : paths(paths) {};
+
+        void open(size_t index, unsigned int lane)
+        {
+            files[lane].close();
+            files[lane].clear();
+            files[lane].open(paths[index].c_str(), std::ios::in | std::ios::binary);
+            if (!files[lane].is_open()) {
+                throwError("hash: failed to open file.");
+            }
+        }
+
+        size_t read(unsigned int lane, byte* out, size_t length)
+        {
+            files[lane].read((char*)out, (std::streamsize)length);
+            if (files[lane].bad()) {
+                throwError("hash: failed to read file.");
+            }
+            return (size_t)files[lane].gcount();
+        }
+
+    private:
+        const std::vector<std::string>& paths;
+        std::ifstream                   files[multibuffer::lanes];
+    };
+
+    /* file at path to digest (DigestSize() bytes) without a filter chain: chunk (Constants::hash_file_chunk bytes) and file are reused
+       for every file, file is unbuffered so the reads go straight to chunk */
+    void hashFile(CryptoPP::HashTransformation& h, std::ifstream& file, const std::string& path, byte* chunk, byte* digest)
+    {
+        file.close();
+        file.clear();
+        file.rdbuf()->pubsetbuf(NULL, 0);
+        file.open(path.c_str(), std::ios::in | std::ios::binary);
+        if (!file.is_open()) {
+            throwError("hash: failed to open file.");
+        }
+        do {
+            file.read((char*)chunk, (std::streamsize)Constants::hash_file_chunk);
+            if (file.bad()) {
+                throwError("hash: failed to read file.");
+            }
+            h.Update(chunk, (size_t)file.gcount());
+        } while (file);
+        h.Final(digest);
+    }
+
+    /* codec of a text encoding, NULL for ascii */
+    codec::Codec* getCodec(Encoding enc, bool uppercase = true, const EncodingAlphabet* alphabet = NULL)
+    {
+        switch (enc)
+        {
+        case Encoding::base16:
+            return new codec::Base16(uppercase);
+        case Encoding::base32:
+            return new codec::Base32(alphabet, uppercase);
+        case Encoding::base64:
+            return new codec::Base64(alphabet);
+        case Encoding::base85:
+            return new codec::Base85(alphabet);
+        default:
+            return NULL;
+        }
+    }
+
+    /* encrypted bytes of in_len bytes before encoding, ecb/cbc add pkcs padding (a whole block if in_len is a multiple of the block size) */
+    size_t cipherLength(size_t in_len, const nppcrypt::Options::Crypt& options)
+    {
+        size_t key_len = options.key.length;
+        size_t block_size, iv_len;
+        getCipherInfo(options.cipher, options.mode, key_len, iv_len, block_size);
+        if (block_size && (options.mode == Mode::ecb || options.mode == Mode::cbc)) {
+            return (in_len / block_size + 1) * block_size;
+        }
+        return in_len;
+    }
+
+    /* block size of the pkcs #7 padding of ecb and cbc (as the cryptopp StreamTransformationFilter), 0: the ciphertext keeps the length */
+    size_t paddingBlock(const nppcrypt::Options::Crypt& options, size_t block_size)
+    {
+        return (options.mode == Mode::ecb || options.mode == Mode::cbc) ? block_size : 0;
+    }
+
+    /* ProcessData() of the cipher class C without the vtable (C::ProcessData is named), the generic StreamTransformation dispatches as usual */
+    template<class C> inline void processData(C& cipher, byte* out, const byte* in, size_t length)
+    {
+        cipher.C::ProcessData(out, in, length);
+    }
+
+    template<> inline void processData(CryptoPP::StreamTransformation& cipher, byte* out, const byte* in, size_t length)
+    {
+        cipher.ProcessData(out, in, length);
+    }
+
+    /* ProcessData() in place, staged through the stack in pieces of Constants::crypt_inplace bytes: some ciphers (aria ctr/cfb/gcm/eax/ccm,
+       desx ctr/cfb) are wrong if input and output are the same memory. The pieces are whole blocks, the stream of the cipher is unchanged */
+    void processInPlace(CryptoPP::StreamTransformation& cipher, byte* data, size_t length)
+    {
+        byte piece[Constants::crypt_inplace];
+        for (size_t done = 0; done < length; done += sizeof(piece)) {
+            size_t n = std::min(sizeof(piece), length - done);
+            cipher.ProcessData(piece, data + done, n);
+            std::memcpy(data + done, piece, n);
+        }
+        CryptoPP::SecureWipeBuffer(piece, sizeof(piece));
+    }
+
+    /* hash() of a hot configuration: the hash H and the codec E are concrete classes, H on the stack and its calls bound statically */
+    template<class H, class E> void hashPipeline(const std::pair<const byte*, size_t>* in, size_t count, std::basic_string<byte>& buffer)
+    {
+        static const E encoder;
+        H h;
+        byte digest[H::DIGESTSIZE];
+        for (size_t i = 0; i < count; i++) {
+            h.H::Update(in[i].first, in[i].second);
+        }
+        h.H::TruncatedFinal(digest, H::DIGESTSIZE);
+        buffer.clear();
+        encoder.encode(digest, H::DIGESTSIZE, buffer);
+    }
+
+    typedef void (*HashPipeline)(const std::pair<const byte*, size_t>*, size_t, std::basic_string<byte>&);
+
+    /* the hot configurations of hash() without key, more can be added here */
+    const struct {
+        Hash            algorithm;
+        size_t          digest_length;
+        Encoding        encoding;
+        HashPipeline    pipeline;
+    } hash_pipelines[] = {
+        { Hash::sha2, 32, Encoding::base16, hashPipeline<CryptoPP::SHA256, codec::Base16> }
+    };
+
+    /* free chunks of SegmentedBuffer, Constants::segment_size bytes each */
+    class SegmentPool
+    {
+    public:
+        ~SegmentPool()
+        {
+            for (size_t i = 0; i < chunks.size(); i++) {
+                delete[] chunks[i];
+            }
+        };
+
+        byte* take()
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (chunks.size()) {
+                    byte* p = chunks.back();
+                    chunks.pop_back();
+                    return p;
+                }
+            }
+            return new byte[Constants::segment_size];
+        };
+
+        void give(byte* p)
+        {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                if (chunks.size() < Constants::segment_pool) {
+                    chunks.push_back(p);
+                    return;
+                }
+            }
+            delete[] p;
+        };
+
+    private:
+        std::mutex          lock;
+        std::vector<byte*>  chunks;
+    } segment_pool;
+
+    /* in to out without a filter chain: one ProcessData() call on the whole span, the last block pkcs #7 padded if padding is not 0.
+       Returns the number of bytes written ( cipherLength() ) */
+    template<class C> size_t encryptDirect(C& cipher, const byte* in, size_t length, byte* out, size_t padding)
+    {
+        if (!padding) {
+            processData(cipher, out, in, length);
+            return length;
+        }
+        size_t whole = length - length % padding;
+        size_t rest = length - whole;
+        byte last[Constants::block_size_max];
+        processData(cipher, out, in, whole);
+        std::memcpy(last, in + whole, rest);
+        std::memset(last + rest, (int)(padding - rest), padding - rest);
+        processData(cipher, out + whole, last, padding);
+        CryptoPP::SecureWipeBuffer(last, padding);
+        return whole + padding;
+    }
+
+    /* strips the pkcs #7 padding of decrypted data, false if it is invalid */
+    bool removePadding(const byte* data, size_t& length, size_t padding)
+    {
+        if (length < padding) {
+            return false;
+        }
+        byte n = data[length - 1];
+        if (n == 0 || n > padding) {
+            return false;
+        }
+        for (size_t i = length - n; i < length; i++) {
+            if (data[i] != n) {
+                return false;
+            }
+        }
+        length -= n;
+        return true;
+    }
+
+    /* characters of length bytes in the encoding of the codec */
+    size_t encodedLength(const codec::Codec* encoder, size_t length, bool linebreaks, size_t linelength, EOL eol)
+    {
+        if (!encoder) {
+            return length;
+        }
+        return encoder->encodedSize(length, linebreaks ? linelength : 0, Strings::eol[(unsigned)eol].size());
+    }
+
+    void calcKey(secure_block& key, const UserData& password, const UserData& salt, const nppcrypt::Options::Crypt::Key& opt)
     {
         using namespace CryptoPP;
         switch (opt.algorithm)
@@ -1103,9 +924,10 @@ namespace intern
             }
             memset(output, 0, sizeof(output));
             // _crypt_blowfish_rn needs 0-terminated password...
-            std::string temp(password.size() + 1, 0);
-            memcpy(&temp[0], password.BytePtr(), password.size());
-            if (_crypt_blowfish_rn(temp.c_str(), settings, output, 64) == NULL) {
+            secure_block temp;
+            temp.CleanNew(password.size() + 1);
+            memcpy(temp.data(), password.BytePtr(), password.size());
+            if (_crypt_blowfish_rn((const char*)temp.data(), settings, output, 64) == NULL) {
                 throwError("bcrypt failed.");
             }
             byte hashdata[23];
@@ -1114,9 +936,6 @@ namespace intern
             memset(output, 0, sizeof(output));
             memset(settings, 0, sizeof(settings));
             memset(hashdata, 0, sizeof(hashdata));
-            for (size_t i = 0; i < temp.size(); i++) {
-                temp[i] = 0;
-            }
             break;
         }
         case KeyDerivation::scrypt:
@@ -1129,6 +948,75 @@ namespace intern
         }
     }
 
+
+    /* random salt of encrypt() */
+    void createSalt(const nppcrypt::Options::Crypt& options, InitData& init)
+    {
+        if (options.key.salt_bytes > 0) {
+            if (options.key.algorithm == KeyDerivation::bcrypt && options.key.salt_bytes != 16) {
+                throwInvalid("encrypt: bcrypt needs 16 byte salt!");
+            }
+            init.salt.random(options.key.salt_bytes);
+        }
+    }
+
+    /* salt of decrypt() */
+    void checkSalt(const nppcrypt::Options::Crypt& options, const InitData& init)
+    {
+        if (options.key.salt_bytes > 0) {
+            if (options.key.algorithm == nppcrypt::KeyDerivation::bcrypt && (options.key.salt_bytes != 16 || init.salt.size() != 16)) {
+                throwInvalid("decrypt: bcrypt needs 16 byte salt!");
+            }
+        }
+    }
+
+    size_t tagSize(Mode mode)
+    {
+        switch (mode)
+        {
+        case Mode::gcm: return Constants::gcm_tag_size;
+        case Mode::ccm: return Constants::ccm_tag_size;
+        case Mode::eax: return Constants::eax_tag_size;
+        default: return 0;
+        }
+    }
+
+    /* the ciphertext is as long as the plaintext: stream ciphers and every mode but ecb and cbc (pkcs padding) */
+    bool keepsLength(const nppcrypt::Options::Crypt& options)
+    {
+        size_t key_len = options.key.length;
+        size_t block_size, iv_len;
+        getCipherInfo(options.cipher, options.mode, key_len, iv_len, block_size);
+        return !block_size || (options.mode != Mode::ecb && options.mode != Mode::cbc);
+    }
+
+    /* data lengths (ccm) and salt and iv as additional authenticated data, before the message of length bytes */
+    void authenticateInitData(CryptoPP::AuthenticatedSymmetricCipher& cipher, const nppcrypt::Options::Crypt& options, const UserData& salt, const byte* iv, size_t iv_len, size_t length)
+    {
+        if (cipher.NeedsPrespecifiedDataLengths()) {
+            cipher.SpecifyDataLengths(options.aad ? (salt.size() + iv_len) : 0, length, 0);
+        }
+        if (options.aad) {
+            cipher.Update(salt.BytePtr(), salt.size());
+            cipher.Update(iv, iv_len);
+        }
+    }
+
+    /* worker threads of an encrypt batch */
+    size_t batchWorkers(size_t count)
+    {
+        if (count < 2 * Constants::batch_thread_min) {
+            return 1;
+        }
+        size_t threads = std::thread::hardware_concurrency();
+        if (threads <= 1) {
+            return 1;
+        }
+        return std::min(threads, count / Constants::batch_thread_min);
+    }
+
+    /* nppcrypt::hash() of count pieces */
+    void hashPieces(Options::Hash& options, std::basic_string<byte>& buffer, const std::pair<const byte*, size_t>* in, size_t count);
 }
 
 // ===========================================================================================================================================================================================
@@ -1144,10 +1032,10 @@ bool nppcrypt::EncodingAlphabet::setup(const char* alphabet, byte padding)
             upper[i] = isalpha(lower[i]) ? toupper(lower[i]) : lower[i];
         }
         CryptoPP::Base32Decoder::InitializeDecodingLookupArray(lookup, &lower[0], 32, true);
-    } else if (length == 64) {
+    } else if (length == 64 || length == 85) {
         lower.assign(alphabet, alphabet + length);
         lower.push_back(0);
-        CryptoPP::Base64Decoder::InitializeDecodingLookupArray(lookup, &lower[0], 64, false);
+        CryptoPP::Base64Decoder::InitializeDecodingLookupArray(lookup, &lower[0], (unsigned int)length, false);
     } else {
         return false;
     }
@@ -1187,26 +1075,7 @@ size_t nppcrypt::UserData::set(const UserData& s)
 
 size_t nppcrypt::UserData::set(std::string& s, Encoding enc)
 {
-    if(enc == Encoding::ascii) {
-        data.Assign((const byte*)s.c_str(), s.size());
-    } else {
-        std::unique_ptr<CryptoPP::BaseN_Decoder> decoder;
-        if (enc == Encoding::base16) {
-            decoder.reset(new CryptoPP::HexDecoder);
-        } else if (enc == Encoding::base32) {
-            decoder.reset(new CryptoPP::Base32Decoder);
-        } else {
-            decoder.reset(new CryptoPP::Base64Decoder);
-        }
-        decoder->Put((const byte*)s.data(), s.size());
-        decoder->MessageEnd();
-        CryptoPP::word64 size = decoder->MaxRetrievable();
-        if (size && size <= SIZE_MAX) {
-            data.resize(size);
-            decoder->Get(&data[0], data.size());
-        }
-    }
-    return data.size();
+    return set(s.data(), s.size(), enc);
 }
 
 size_t nppcrypt::UserData::set(const char* s, size_t length, Encoding enc)
@@ -1214,20 +1083,12 @@ size_t nppcrypt::UserData::set(const char* s, size_t length, Encoding enc)
     if (enc == Encoding::ascii) {
         data.Assign((const byte*)s, length);
     } else {
-        std::unique_ptr<CryptoPP::BaseN_Decoder> decoder;
-        if (enc == Encoding::base16) {
-            decoder.reset(new CryptoPP::HexDecoder);
-        } else if (enc == Encoding::base32) {
-            decoder.reset(new CryptoPP::Base32Decoder);
-        } else {
-            decoder.reset(new CryptoPP::Base64Decoder);
-        }
-        decoder->Put((const byte*)s, length);
-        decoder->MessageEnd();
-        CryptoPP::word64 size = decoder->MaxRetrievable();
-        if (size && size <= SIZE_MAX) {
-            data.resize(size);
-            decoder->Get(&data[0], data.size());
+        /* decoded straight into the secure block */
+        std::unique_ptr<codec::Codec> decoder(intern::getCodec(enc));
+        size_t size = decoder->decodedSize(length);
+        if (size) {
+            data.New(size);
+            data.resize(decoder->decode((const byte*)s, length, data.BytePtr()));
         }
     }
     return data.size();
@@ -1331,23 +1192,9 @@ void nppcrypt::UserData::get(std::string& s, Encoding enc) const
         if (enc == Encoding::ascii) {
             s.assign((const char*)data.BytePtr(), data.size());
         } else {
-            std::unique_ptr<CryptoPP::SimpleProxyFilter> encoder;
-            if (enc == Encoding::base16) {
-                encoder.reset(new CryptoPP::HexEncoder);
-            } else if (enc == Encoding::base32) {
-                encoder.reset(new CryptoPP::Base32Encoder);
-            } else {
-                encoder.reset(new CryptoPP::Base64Encoder(0,false));
-            }
-            encoder->Put(data.BytePtr(), data.size());
-            encoder->MessageEnd();
-            CryptoPP::word64 size = encoder->MaxRetrievable();
-            if (size && size <= SIZE_MAX) {
-                s.resize(size);
-                encoder->Get((byte*)&s[0], s.size());
-            } else {
-                s.clear();
-            }
+            std::unique_ptr<codec::Codec> encoder(intern::getCodec(enc));
+            s.resize(encoder->encodedSize(data.size()));
+            encoder->encode(data.BytePtr(), data.size(), (byte*)&s[0]);
         }
     } else {
         s.clear();
@@ -1360,23 +1207,9 @@ void nppcrypt::UserData::get(secure_string& s, Encoding enc) const
         if (enc == Encoding::ascii) {
             s.assign((const char*)data.BytePtr(), data.size());
         } else {
-            std::unique_ptr<CryptoPP::SimpleProxyFilter> encoder;
-            if (enc == Encoding::base16) {
-                encoder.reset(new CryptoPP::HexEncoder);
-            } else if (enc == Encoding::base32) {
-                encoder.reset(new CryptoPP::Base32Encoder);
-            } else {
-                encoder.reset(new CryptoPP::Base64Encoder(0, false));
-            }
-            encoder->Put(data.BytePtr(), data.size());
-            encoder->MessageEnd();
-            CryptoPP::word64 size = encoder->MaxRetrievable();
-            if (size && size <= SIZE_MAX) {
-                s.resize(size);
-                encoder->Get((byte*)&s[0], s.size());
-            } else {
-                s.clear();
-            }
+            std::unique_ptr<codec::Codec> encoder(intern::getCodec(enc));
+            s.resize(encoder->encodedSize(data.size()));
+            encoder->encode(data.BytePtr(), data.size(), (byte*)&s[0]);
         }
     } else {
         s.clear();
@@ -1392,196 +1225,13 @@ void nppcrypt::UserData::clear()
 
 bool nppcrypt::getCipherInfo(nppcrypt::Cipher cipher, nppcrypt::Mode mode, size_t& key_length, size_t& iv_length, size_t& block_size)
 {
-    using namespace CryptoPP;
-    switch (cipher)
-    {
-    case Cipher::threeway:
-        block_size = iv_length = ThreeWay::BLOCKSIZE;
-        key_length = ThreeWay::KEYLENGTH;
-        break;
-    case Cipher::aria:
-        block_size = iv_length = ARIA::BLOCKSIZE;
-        key_length = (key_length == 0) ? ARIA::DEFAULT_KEYLENGTH : ARIA::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::blowfish:
-        block_size = iv_length = Blowfish::BLOCKSIZE;
-        key_length = (key_length == 0) ? Blowfish::DEFAULT_KEYLENGTH : Blowfish::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::camellia:
-        block_size = iv_length = Camellia::BLOCKSIZE;
-        key_length = (key_length == 0) ? Camellia::DEFAULT_KEYLENGTH : Camellia::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::cast128:
-        block_size = iv_length = CAST128::BLOCKSIZE;
-        key_length = (key_length == 0) ? CAST128::DEFAULT_KEYLENGTH : CAST128::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::cast256:
-        block_size = iv_length = CAST256::BLOCKSIZE;
-        key_length = (key_length == 0) ? CAST256::DEFAULT_KEYLENGTH : CAST256::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::chacha20:
-        block_size = 0;
-        iv_length = ChaCha::IV_LENGTH;
-        key_length = (key_length == 0) ? ChaCha::DEFAULT_KEYLENGTH : ChaCha::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::des:
-        block_size = iv_length = DES::BLOCKSIZE;
-        key_length = DES::KEYLENGTH;
-        break;
-    case Cipher::des_ede2:
-        block_size = iv_length = DES_EDE2::BLOCKSIZE;
-        key_length = DES_EDE2::KEYLENGTH;
-        break;
-    case Cipher::des_ede3:
-        block_size = iv_length = DES_EDE3::BLOCKSIZE;
-        key_length = DES_EDE3::KEYLENGTH;
-        break;
-    case Cipher::desx:
-        block_size = iv_length = DES_XEX3::BLOCKSIZE;
-        key_length = DES_XEX3::KEYLENGTH;
-        break;
-    case Cipher::gost:
-        block_size = iv_length = GOST::BLOCKSIZE;
-        key_length = GOST::KEYLENGTH;
-        break;
-    case Cipher::idea:
-        block_size = iv_length = IDEA::BLOCKSIZE;
-        key_length = IDEA::KEYLENGTH;
-        break;
-    case Cipher::kalyna128:
-        block_size = iv_length = Kalyna128::BLOCKSIZE;
-        key_length = (key_length == 0) ? Kalyna128::DEFAULT_KEYLENGTH : Kalyna128::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::kalyna256:
-        block_size = iv_length = Kalyna256::BLOCKSIZE;
-        key_length = (key_length == 0) ? Kalyna256::DEFAULT_KEYLENGTH : Kalyna256::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::kalyna512:
-        block_size = iv_length = 64;
-        key_length = 64;
-        break;
-    case Cipher::mars:
-        block_size = iv_length = MARS::BLOCKSIZE;
-        key_length = (key_length == 0) ? MARS::DEFAULT_KEYLENGTH : MARS::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::panama:
-        block_size = 0;
-        key_length = PanamaCipher<LittleEndian>::KEYLENGTH;
-        iv_length = PanamaCipher<LittleEndian>::IV_LENGTH;
-        break;
-    case Cipher::rc2:
-        block_size = iv_length = RC2::BLOCKSIZE;
-        key_length = (key_length == 0) ? RC2::DEFAULT_KEYLENGTH : RC2::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::rc4:
-        block_size = iv_length = 0;
-        key_length = (key_length == 0) ? Weak::ARC4::DEFAULT_KEYLENGTH : Weak::ARC4::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::rc5:
-        block_size = iv_length = RC5::BLOCKSIZE;
-        key_length = (key_length == 0) ? RC5::DEFAULT_KEYLENGTH : RC5::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::rc6:
-        block_size = iv_length = RC6::BLOCKSIZE;
-        key_length = (key_length == 0) ? RC6::DEFAULT_KEYLENGTH : RC6::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::rijndael:
-        block_size = iv_length = AES::BLOCKSIZE;
-        key_length = (key_length == 0) ? 32 : AES::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::saferk:
-        block_size = iv_length = SAFER_K::BLOCKSIZE;
-        key_length = (key_length == 0) ? SAFER_K::DEFAULT_KEYLENGTH : SAFER_K::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::safersk:
-        block_size = iv_length = SAFER_SK::BLOCKSIZE;
-        key_length = (key_length == 0) ? SAFER_SK::DEFAULT_KEYLENGTH : SAFER_SK::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::salsa20:
-        block_size = 0;
-        iv_length = Salsa20::IV_LENGTH;
-        key_length = (key_length == 0) ? Salsa20::DEFAULT_KEYLENGTH : Salsa20::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::seal:
-        block_size = 0;
-        iv_length = SEAL<LittleEndian>::IV_LENGTH;
-        key_length = SEAL<LittleEndian>::KEYLENGTH;
-        break;
-    case Cipher::seed:
-        block_size = iv_length = SEED::BLOCKSIZE;
-        key_length = SEED::KEYLENGTH;
-        break;
-    case Cipher::serpent:
-        block_size = iv_length = Serpent::BLOCKSIZE;
-        key_length = (key_length == 0) ? Serpent::DEFAULT_KEYLENGTH : Serpent::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::shacal2:
-        block_size = iv_length = SHACAL2::BLOCKSIZE;
-        key_length = (key_length == 0) ? SHACAL2::DEFAULT_KEYLENGTH : SHACAL2::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::shark:
-        block_size = iv_length = SHARK::BLOCKSIZE;
-        key_length = SHARK::KEYLENGTH;
-        break;
-    case Cipher::simon128:
-        block_size = iv_length = SIMON128::BLOCKSIZE;
-        key_length = (key_length == 0) ? SIMON128::DEFAULT_KEYLENGTH : SIMON128::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::skipjack:
-        block_size = iv_length = SKIPJACK::BLOCKSIZE;
-        key_length = SKIPJACK::KEYLENGTH;
-        break;
-    case Cipher::sm4:
-        block_size = iv_length = SM4::BLOCKSIZE;
-        key_length = SM4::KEYLENGTH;
-        break;
-    case Cipher::sosemanuk:
-        block_size = 0;
-        iv_length = Sosemanuk::IV_LENGTH;
-        key_length = (key_length == 0) ? Sosemanuk::DEFAULT_KEYLENGTH : Sosemanuk::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::speck128:
-        block_size = iv_length = SPECK128::BLOCKSIZE;
-        key_length = (key_length == 0) ? SPECK128::DEFAULT_KEYLENGTH : SPECK128::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::square:
-        block_size = iv_length = Square::BLOCKSIZE;
-        key_length = Square::KEYLENGTH;
-        break;
-    case Cipher::tea:
-        block_size = iv_length = TEA::BLOCKSIZE;
-        key_length = TEA::KEYLENGTH;
-        break;
-    case Cipher::threefish256:
-        block_size = iv_length = Threefish256::BLOCKSIZE;
-        key_length = Threefish256::KEYLENGTH;
-        break;
-    case Cipher::threefish512:
-        block_size = iv_length = 64;
-        key_length = 64;
-        break;
-    case Cipher::threefish1024:
-        block_size = iv_length = 128;
-        key_length = 128;
-        break;
-    case Cipher::twofish:
-        block_size = iv_length = Twofish::BLOCKSIZE;
-        key_length = (key_length == 0) ? Twofish::DEFAULT_KEYLENGTH : Twofish::StaticGetValidKeyLength(key_length);
-        break;
-    case Cipher::wake:
-        block_size = iv_length = 0;
-        key_length = WAKE_OFB<LittleEndian>::KEYLENGTH;
-        break;
-    case Cipher::xsalsa20:
-        block_size = 0;
-        iv_length = XSalsa20::IV_LENGTH;
-        key_length = XSalsa20::KEYLENGTH;
-        break;
-    case Cipher::xtea:
-        block_size = iv_length = XTEA::BLOCKSIZE;
-        key_length = XTEA::KEYLENGTH;
-        break;
+    const intern::registry::CipherEntry* entry = intern::registry::find(cipher);
+    if (!entry) {
+        return false;
     }
+    key_length = entry->keyLength(key_length);
+    block_size = entry->block_size;
+    iv_length = entry->iv_length;
     if (block_size > 0) {
         if (mode == Mode::ccm) {
             iv_length = Constants::ccm_iv_length;
@@ -1614,6 +1264,7 @@ bool nppcrypt::getHashInfo(Hash h, size_t& length, size_t& keylength)
     }
     case Hash::cmac_aes: length = 16; keylength = 16; break;
     case Hash::crc32: length = 4; break;
+    case Hash::crc32c: length = 4; break;
     case Hash::keccak:
     {
         if (length != 28 && length != 32 && length != 48 && length != 64) {
@@ -1624,6 +1275,20 @@ bool nppcrypt::getHashInfo(Hash h, size_t& length, size_t& keylength)
     case Hash::md2: length = 16; break;
     case Hash::md4: length = 16; break;
     case Hash::md5: length = 16; break;
+    case Hash::parallelhash128:
+    {
+        if (length != 16 && length != 32 && length != 48 && length != 64) {
+            length = 32;
+        }
+        break;
+    }
+    case Hash::parallelhash256:
+    {
+        if (length != 16 && length != 32 && length != 48 && length != 64) {
+            length = 64;
+        }
+        break;
+    }
     case Hash::ripemd:
     {
         if (length != 16 && length != 20 && length != 32 && length != 40) {
@@ -1671,166 +1336,275 @@ bool nppcrypt::getHashInfo(Hash h, size_t& length, size_t& keylength)
         break;
     }
     case Hash::whirlpool: length = 64; break;
+    case Hash::xxh3:
+    {
+        if (length != 16) {
+            length = 8;
+        }
+        break;
+    }
     default: return false;
     }
     return true;
 }
 
-void nppcrypt::encrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init)
+size_t nppcrypt::encryptedSize(size_t in_len, const Options::Crypt& options)
 {
-    using namespace CryptoPP;
+    std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.encoding.enc, options.encoding.uppercase));
+    return intern::encodedLength(encoder.get(), intern::cipherLength(in_len, options), options.encoding.linebreaks, options.encoding.linelength, options.encoding.eol);
+}
 
-    if (!in || !in_len) {
-        throwInvalid("encrypt: invalid input.");
+size_t nppcrypt::decryptedSize(size_t in_len, const Options::Crypt& options)
+{
+    /* padding and tags only remove bytes */
+    std::unique_ptr<codec::Codec> decoder(intern::getCodec(options.encoding.enc));
+    return decoder ? decoder->decodedSize(in_len) : in_len;
+}
+
+size_t nppcrypt::convertedSize(size_t in_len, const Options::Convert& options, const EncodingAlphabet* base32_alphabet, const EncodingAlphabet* base64_alphabet, const EncodingAlphabet* base85_alphabet)
+{
+    const EncodingAlphabet* alphabets[] = { NULL, NULL, base32_alphabet, base64_alphabet, base85_alphabet };
+
+    if (options.from == options.to) {
+        return 0;
     }
-    
-    SecByteBlock        tKey;
-    const byte*         ptVec = NULL;
-    const byte*         ptSalt = NULL;
-    size_t              key_len = options.key.length;
-    size_t              block_size, iv_len;
+    std::unique_ptr<codec::Codec> decoder(intern::getCodec(options.from, true, alphabets[(unsigned)options.from]));
+    std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.to, options.uppercase, alphabets[(unsigned)options.to]));
+    size_t length = decoder ? decoder->decodedSize(in_len) : in_len;
+    return intern::encodedLength(encoder.get(), length, options.linebreaks, options.linelength, options.eol);
+}
 
-    getCipherInfo(options.cipher, options.mode, key_len, iv_len, block_size);
+nppcrypt::SegmentedBuffer::~SegmentedBuffer()
+{
+    clear();
+}
 
-    // --------------------------- prepare salt vector:
-    if (options.key.salt_bytes > 0) {
-        if (options.key.algorithm == KeyDerivation::bcrypt && options.key.salt_bytes != 16) {
-            throwInvalid("encrypt: bcrypt needs 16 byte salt!");
-        }
-        init.salt.random(options.key.salt_bytes);
-        ptSalt = init.salt.BytePtr();
+byte* nppcrypt::SegmentedBuffer::append(size_t n)
+{
+    if (!parts.size() || parts.back().capacity - parts.back().size < n) {
+        Part part = { NULL, 0, std::max(n, Constants::segment_size) };
+        parts.reserve(parts.size() + 1);
+        part.data = (part.capacity == Constants::segment_size) ? intern::segment_pool.take() : new byte[part.capacity];
+        parts.push_back(part);
     }
-    // --------------------------- prepare iv & key vector
-    if (options.iv == nppcrypt::IV::keyderivation) {
-        tKey.resize(key_len + iv_len);
-    } else {
-        tKey.resize(key_len);
+    Part& last = parts.back();
+    byte* p = last.data + last.size;
+    last.size += n;
+    length += n;
+    return p;
+}
+
+void nppcrypt::SegmentedBuffer::append(const byte* data, size_t n)
+{
+    while (n) {
+        size_t room = parts.size() ? parts.back().capacity - parts.back().size : 0;
+        size_t m = std::min(n, room ? room : Constants::segment_size);
+        std::memcpy(append(m), data, m);
+        data += m;
+        n -= m;
     }
-    if (iv_len > 0) {
-        switch (options.iv) {
-        case IV::keyderivation:
-            ptVec = &tKey[key_len];
-            break;
-        case IV::random:
-            init.iv.random(iv_len);
-            ptVec = init.iv.BytePtr();
-            break;
-        case IV::zero:
-            init.iv.zero(iv_len);
-            ptVec = init.iv.BytePtr();
-            break;
-        case IV::custom:
-            if (iv_len != init.iv.size()) {
-                throwInvalid("encrypt: invalid custom IV length.");
-            }
-            ptVec = init.iv.BytePtr();
-            break;
+}
+
+void nppcrypt::SegmentedBuffer::clear()
+{
+    for (size_t i = 0; i < parts.size(); i++) {
+        if (parts[i].capacity == Constants::segment_size) {
+            intern::segment_pool.give(parts[i].data);
+        } else {
+            delete[] parts[i].data;
         }
     }
-    // --------------------------- calculate key
-    intern::calcKey(tKey, password, init.salt, options.key);
+    parts.clear();
+    length = 0;
+}
 
-    if (options.iv == IV::keyderivation) {
-        init.iv.set(ptVec, iv_len);
+void nppcrypt::SegmentedBuffer::copy(plain_string& out) const
+{
+    out.reserve(out.size() + length);
+    for (size_t i = 0; i < parts.size(); i++) {
+        out.append(parts[i].data, parts[i].size);
     }
+}
 
-    try {
-        if (block_size && (options.mode == Mode::gcm || options.mode == Mode::ccm || options.mode == Mode::eax)) {
-            std::unique_ptr<AuthenticatedSymmetricCipher> penc(intern::getAuthenticatedCipher(options.cipher, options.mode, true));
-            if (!penc) {
-                throwError("encrypt: Failed to create AuthenticatedSymmetricCipher.");
-            }
-            int tag_size;
-            switch (options.mode)
-            {
-            case Mode::gcm: tag_size = Constants::gcm_tag_size; break;
-            case Mode::ccm: tag_size = Constants::ccm_tag_size;  break;
-            case Mode::eax: tag_size = Constants::eax_tag_size;  break;
-            }
+nppcrypt::CipherContext::CipherContext(const Options::Crypt& opt, const UserData& password, const UserData& s)
+    : options(opt), key_len(opt.key.length), iv_len(0), block_size(0), pipeline(&CipherContext::encryptWith<CryptoPP::StreamTransformation>),
+      encrypted(std::make_shared<std::atomic<bool>>(false))
+{
+    getCipherInfo(options.cipher, options.mode, key_len, iv_len, block_size);
+    if (options.key.algorithm == KeyDerivation::bcrypt && s.size() != 16) {
+        throwInvalid("bcrypt needs 16 byte salt!");
+    }
+    salt.set(s);
+    key.resize((options.iv == IV::keyderivation) ? key_len + iv_len : key_len);
+    intern::calcKey(key, password, salt, options.key);
+    encoder.reset(intern::getCodec(options.encoding.enc, options.encoding.uppercase));
+
+    /* the hot configurations get a pipeline bound to their cipher class at compile time, all others the generic one.
+       The class has to be the one intern::registry creates for cipher and mode (the mode is ignored for stream ciphers) */
+    static const struct {
+        Cipher      cipher;
+        Mode        mode;
+        Encoding    encoding;
+        Pipeline    pipeline;
+    } pipelines[] = {
+        { Cipher::rijndael, Mode::gcm, Encoding::base64, &CipherContext::encryptWith<CryptoPP::GCM<CryptoPP::AES>::Encryption> },
+        { Cipher::rijndael, Mode::gcm, Encoding::ascii, &CipherContext::encryptWith<CryptoPP::GCM<CryptoPP::AES>::Encryption> },
+        { Cipher::chacha20, Mode::ecb, Encoding::ascii, &CipherContext::encryptWith<CryptoPP::ChaCha::Encryption> }
+    };
+    for (size_t i = 0; i < sizeof(pipelines) / sizeof(pipelines[0]); i++) {
+        if (pipelines[i].cipher == options.cipher && (pipelines[i].mode == options.mode || !block_size) && pipelines[i].encoding == options.encoding.enc) {
+            pipeline = pipelines[i].pipeline;
+            break;
+        }
+    }
+}
 
-            penc->SetKeyWithIV(tKey.data(), key_len, ptVec, iv_len);
-            if (penc->NeedsPrespecifiedDataLengths()) {
-                penc->SpecifyDataLengths(options.aad ? (init.salt.size() + init.iv.size()) : 0, in_len, 0);
-            }
+nppcrypt::CipherContext::CipherContext(const CipherContext& other)
+    : options(other.options), salt(other.salt), key(other.key), key_len(other.key_len), iv_len(other.iv_len), block_size(other.block_size),
+      pipeline(other.pipeline), encoder(intern::getCodec(options.encoding.enc, options.encoding.uppercase)), encrypted(other.encrypted)
+{
+}
 
-            AuthenticatedEncryptionFilter ef(*penc, NULL, false, tag_size );
-            std::basic_string<byte> temp;
-            if (options.encoding.enc == Encoding::ascii) {
-                ef.Attach(new StringSinkTemplate<std::basic_string<byte>>(buffer));
-            } else {
-                ef.Attach(new StringSinkTemplate<std::basic_string<byte>>(temp));
-            }
+nppcrypt::CipherContext::~CipherContext()
+{
+}
 
-            if (options.aad) {
-                ef.ChannelPut(AAD_CHANNEL, init.salt.BytePtr(), init.salt.size());
-                ef.ChannelPut(AAD_CHANNEL, init.iv.BytePtr(), init.iv.size());
-                ef.ChannelMessageEnd(AAD_CHANNEL);
-            }
-            ef.ChannelPut(DEFAULT_CHANNEL, in, in_len);
-            ef.ChannelMessageEnd( DEFAULT_CHANNEL );
+bool nppcrypt::CipherContext::isAuthenticated() const
+{
+    return block_size && (options.mode == Mode::gcm || options.mode == Mode::ccm || options.mode == Mode::eax);
+}
 
-            switch (options.encoding.enc)
-            {
-            case Encoding::ascii:
-            {
-                init.tag.set(buffer.data() + buffer.size() - tag_size, tag_size);
-                buffer.resize(buffer.size() - tag_size);
-                break;
-            }
-            case Encoding::base16: case Encoding::base32: case Encoding::base64:
-            {
-                int linelength = options.encoding.linebreaks ? (int)options.encoding.linelength : 0;
-                const std::string& s_eol = Strings::eol[(int)options.encoding.eol];
-                if (options.encoding.enc == Encoding::base16) {
-                    StringSource(temp.data(), temp.size() - tag_size, true, new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer),
-                        options.encoding.uppercase, linelength, s_eol));
-                } else if (options.encoding.enc == Encoding::base32) {
-                    StringSource(temp.data(), temp.size() - tag_size, true, new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer),
-                        options.encoding.uppercase, linelength, s_eol));
-                } else {
-                    StringSource(temp.data(), temp.size() - tag_size, true, new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer),
-                        linelength, s_eol));
-                }
-                init.tag.set(temp.data() + temp.size() - tag_size, tag_size);
-                break;
-            }
-            }
+void nppcrypt::CipherContext::checkReuse()
+{
+    if ((!iv_len || options.iv != IV::random) && encrypted->exchange(true)) {
+        throwInvalid("encrypt: a second message under the same key needs random IVs.");
+    }
+}
+
+const byte* nppcrypt::CipherContext::encryptionIV(InitData& init) const
+{
+    init.salt.set(salt);
+    if (!iv_len) {
+        return NULL;
+    }
+    switch (options.iv) {
+    case IV::keyderivation:
+        init.iv.set(&key[key_len], iv_len);
+        break;
+    case IV::random:
+        init.iv.random(iv_len);
+        break;
+    case IV::zero:
+        init.iv.zero(iv_len);
+        break;
+    case IV::custom:
+        if (iv_len != init.iv.size()) {
+            throwInvalid("encrypt: invalid custom IV length.");
+        }
+        break;
+    }
+    return init.iv.BytePtr();
+}
+
+const byte* nppcrypt::CipherContext::decryptionIV(const InitData& init) const
+{
+    if (!iv_len) {
+        return NULL;
+    }
+    if (!init.iv.size()) {
+        if (options.iv == IV::keyderivation) {
+            return &key[key_len];
+        }
+        throwInvalid("decrypt: missing IV.");
+    }
+    if (init.iv.size() != iv_len) {
+        throwInvalid("decrypt: invalid IV length.")
+    }
+    return init.iv.BytePtr();
+}
+
+void nppcrypt::CipherContext::setKey(CryptoPP::SimpleKeyingInterface& cipher, bool created, const byte* iv) const
+{
+    if (created) {
+        if (iv_len == 0) {
+            cipher.SetKey(key.data(), key_len);
         } else {
-            std::unique_ptr<SymmetricCipher> pEnc(intern::getSymmetricCipher(options.cipher, options.mode, true));
-            if (!pEnc) {
+            cipher.SetKeyWithIV(key.data(), key_len, iv, iv_len);
+        }
+    } else if (iv_len) {
+        cipher.Resynchronize(iv, (int)iv_len);
+    } else if (!block_size) {
+        /* rc4, wake: no iv, the key stream has to start over */
+        cipher.SetKey(key.data(), key_len);
+    }
+}
+
+CryptoPP::SymmetricCipher& nppcrypt::CipherContext::symmetricCipher(bool encryption, const byte* iv)
+{
+    std::unique_ptr<CryptoPP::SymmetricCipher>& cipher = sym[encryption];
+    bool created = !cipher;
+    if (created) {
+        cipher.reset(intern::getSymmetricCipher(options.cipher, options.mode, encryption));
+        if (!cipher) {
+            if (encryption) {
                 throwError("encrypt: Failed to create SymmetricCipher.");
-            }
-            if (iv_len == 0) {
-                pEnc->SetKey(tKey.data(), key_len);
             } else {
-                pEnc->SetKeyWithIV(tKey.data(), key_len, ptVec, iv_len);
-            }
-            switch (options.encoding.enc)
-            {
-            case Encoding::ascii:
-            {
-                StringSource(in, in_len, true, new StreamTransformationFilter(*pEnc, new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-                break;
-            }
-            case Encoding::base16: case Encoding::base32: case Encoding::base64:
-            {
-                int linelength = options.encoding.linebreaks ? (int)options.encoding.linelength : 0;
-                const std::string& s_eol = Strings::eol[(int)options.encoding.eol];
-                if (options.encoding.enc == Encoding::base16) {
-                    StringSource(in, in_len, true, new StreamTransformationFilter(*pEnc,
-                        new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.encoding.uppercase, linelength, s_eol)));
-                } else if (options.encoding.enc == Encoding::base32) {
-                    StringSource(in, in_len, true, new StreamTransformationFilter(*pEnc,
-                            new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.encoding.uppercase, linelength, s_eol)));
-                } else {
-                    StringSource(in, in_len, true, new StreamTransformationFilter(*pEnc,
-                        new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), linelength, s_eol)
-                    ));
-                }
-                break;
+                throwError("decrypt: failed to create SymmetricCipher.");
             }
+        }
+    }
+    setKey(*cipher, created, iv);
+    return *cipher;
+}
+
+CryptoPP::AuthenticatedSymmetricCipher& nppcrypt::CipherContext::authenticatedCipher(bool encryption, const byte* iv)
+{
+    std::unique_ptr<CryptoPP::AuthenticatedSymmetricCipher>& cipher = aead[encryption];
+    bool created = !cipher;
+    if (created) {
+        cipher.reset(intern::getAuthenticatedCipher(options.cipher, options.mode, encryption));
+        if (!cipher) {
+            if (encryption) {
+                throwError("encrypt: Failed to create AuthenticatedSymmetricCipher.");
+            } else {
+                throwError("decrypt: failed to create AuthenticatedSymmetricCipher.");
             }
         }
+    }
+    setKey(*cipher, created, iv);
+    return *cipher;
+}
+
+void nppcrypt::CipherContext::encrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, InitData& init)
+{
+    if (!in || !in_len) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    size_t offset = buffer.size();
+    buffer.resize(offset + outputSize(in_len));
+    Output out = { &buffer[offset], NULL };
+    encryptTo(in, in_len, out, init);
+}
+
+void nppcrypt::CipherContext::encrypt(const byte* in, size_t in_len, SegmentedBuffer& buffer, InitData& init)
+{
+    if (!in || !in_len) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    Output out = { NULL, &buffer };
+    encryptTo(in, in_len, out, init);
+}
+
+void nppcrypt::CipherContext::encryptTo(const byte* in, size_t in_len, Output& out, InitData& init)
+{
+    try {
+        const byte* ptVec = encryptionIV(init);
+        checkReuse();
+        byte tag[Constants::tag_size_max];
+        encryptMessage(in, in_len, out, ptVec, tag);
+        if (isAuthenticated()) {
+            init.tag.set(tag, intern::tagSize(options.mode));
+        }
     } catch (CryptoPP::Exception& exc) {
         throwError(exc.GetWhat());
     } catch (nppcrypt::Exception& exc) {
@@ -1838,162 +1612,256 @@ void nppcrypt::encrypt(const byte* in, size_t in_len, std::basic_string<byte>& b
     } catch (...) {
         throwError("encrypt: unexpected error.");
     }
- }
+}
 
-void nppcrypt::decrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init)
+void nppcrypt::CipherContext::encryptMessage(const byte* in, size_t in_len, Output& out, const byte* ptVec, byte* tag)
 {
-    if (!in || !in_len) {
-        throwInvalid("decrypt: invalid input.");
-    }
-
-    using namespace nppcrypt;
     using namespace CryptoPP;
 
-    SecByteBlock        tKey;
-    const byte*         ptVec = NULL;
-    const byte*         ptSalt = NULL;
-    size_t              key_len = options.key.length;
-    size_t              block_size, iv_len;
+    /* no filter chain: the cipher processes the whole input (or chunks of it) straight into the output */
+    size_t padding = intern::paddingBlock(options, block_size);
+    if (isAuthenticated()) {
+        AuthenticatedSymmetricCipher& penc = authenticatedCipher(true, ptVec);
+        intern::authenticateInitData(penc, options, salt, ptVec, iv_len, in_len);
+        (this->*pipeline)(penc, in, in_len, out, padding);
+        penc.TruncatedFinal(tag, intern::tagSize(options.mode));
+    } else {
+        (this->*pipeline)(symmetricCipher(true, ptVec), in, in_len, out, padding);
+    }
+}
 
-    getCipherInfo(options.cipher, options.mode, key_len, iv_len, block_size);
+size_t nppcrypt::CipherContext::outputSize(size_t in_len) const
+{
+    size_t padding = intern::paddingBlock(options, block_size);
+    size_t length = padding ? (in_len / padding + 1) * padding : in_len;
+    return intern::encodedLength(encoder.get(), length, options.encoding.linebreaks, options.encoding.linelength, options.encoding.eol);
+}
 
-    // --------------------------- prepare salt vector:
-    if (options.key.salt_bytes > 0) {
-        if (options.key.algorithm == nppcrypt::KeyDerivation::bcrypt && (options.key.salt_bytes != 16 || init.salt.size() != 16)) {
-            throwInvalid("decrypt: bcrypt needs 16 byte salt!");
-        }
-        ptSalt = init.salt.BytePtr();
-    }
+template<class C> void nppcrypt::CipherContext::encryptWith(CryptoPP::StreamTransformation& base, const byte* in, size_t in_len, Output& out, size_t padding)
+{
+    using namespace CryptoPP;
 
-    // --------------------------- prepare iv vector & key-block:
-    tKey.resize(key_len);
-    if (iv_len > 0) {
-        if (!init.iv.size()) {
-            throwInvalid("decrypt: missing IV.");
+    C& cipher = static_cast<C&>(base);
+    if (!encoder) {
+        /* contiguous output in one piece, segmented output a segment at a time */
+        size_t chunk = in_len;
+        if (out.segments) {
+            chunk = padding ? Constants::segment_size / padding * padding : Constants::segment_size;
         }
-        if (init.iv.size() != iv_len) {
-            throwInvalid("decrypt: invalid IV length.")
+        size_t done = 0;
+        for (; in_len - done > chunk; done += chunk) {
+            intern::processData(cipher, out.take(chunk), in + done, chunk);
         }
-        ptVec = init.iv.BytePtr();
+        size_t n = in_len - done;
+        intern::encryptDirect(cipher, in + done, n, out.take(padding ? (n / padding + 1) * padding : n), padding);
+        return;
+    }
+
+    /* one pass: chunks of whole lines (and blocks) are encrypted to a small buffer and encoded straight into the output */
+    size_t linelength = options.encoding.linebreaks ? options.encoding.linelength : 0;
+    const std::string& s_eol = Strings::eol[(int)options.encoding.eol];
+    size_t unit = encoder->lineBytes(linelength);
+    if (padding) {
+        unit *= padding;
+    }
+    size_t chunk = (Constants::crypt_chunk > unit) ? Constants::crypt_chunk / unit * unit : unit;
+    if (out.segments) {
+        /* a whole number of chunks per segment, the segments are filled up to a few lines */
+        size_t eol_len = linelength ? s_eol.size() : 0;
+        size_t units = Constants::segment_size / (encoder->encodedSize(unit, linelength, s_eol.size()) + eol_len);
+        size_t parts = (Constants::segment_size + Constants::crypt_chunk - 1) / Constants::crypt_chunk;
+        chunk = std::max<size_t>(units / parts, 1) * unit;
+    }
+    /* temp only holds ciphertext: not wiped. Short messages (the common case of the pipelines) need no heap block */
+    byte small[Constants::crypt_stack];
+    std::unique_ptr<byte[]> large;
+    byte* temp = small;
+    if (std::min(chunk, in_len) + padding > Constants::crypt_stack) {
+        large.reset(new byte[std::min(chunk, in_len) + padding]);
+        temp = large.get();
     }
 
-    // --------------------------- calculate key:
-    intern::calcKey(tKey, password, init.salt, options.key);
+    size_t done = 0;
+    do {
+        size_t n = std::min(chunk, in_len - done);
+        size_t m = n;
+        if (done + n < in_len) {
+            intern::processData(cipher, temp, in + done, n);
+        } else {
+            m = intern::encryptDirect(cipher, in + done, n, temp, padding);
+        }
+        size_t eol_len = (done && linelength) ? s_eol.size() : 0;
+        byte* o = out.take(eol_len + encoder->encodedSize(m, linelength, s_eol.size()));
+        std::memcpy(o, s_eol.data(), eol_len);
+        encoder->encode(temp, m, o + eol_len, linelength, s_eol);
+        done += n;
+    } while (done < in_len);
+}
 
-    try {
-        if (block_size && (options.mode == Mode::gcm || options.mode == Mode::ccm || options.mode == Mode::eax)) {
-            std::unique_ptr<AuthenticatedSymmetricCipher> penc(intern::getAuthenticatedCipher(options.cipher, options.mode, false));
+void nppcrypt::CipherContext::encrypt(const std::pair<const byte*, size_t>* in, size_t count, CryptBatch& out)
+{
+    using namespace CryptoPP;
 
-            int tag_size;
-            switch (options.mode)
-            {
-            case Mode::gcm: tag_size = Constants::gcm_tag_size; break;
-            case Mode::ccm: tag_size = Constants::ccm_tag_size;  break;
-            case Mode::eax: tag_size = Constants::eax_tag_size;  break;
-            }
-            penc->SetKeyWithIV(tKey.data(), key_len, ptVec, iv_len);
+    if (!in && count) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    /* one key for all messages: without an iv (rc4, wake, ecb) they would share the key stream or the block mapping */
+    if (!iv_len) {
+        throwInvalid("encrypt: a batch needs a cipher with an iv (not rc4, wake or ecb).");
+    }
+    if (options.iv != IV::random) {
+        throwInvalid("encrypt: a batch needs random IVs.");
+    }
 
-            std::basic_string<byte> temp;
-            const byte*             pEncrypted;
-            size_t                  Encrypted_size;
-                
-            switch (options.encoding.enc)
-            {
-            case Encoding::ascii:
-            {
-                pEncrypted = in;
-                Encrypted_size = in_len;
-                break;
-            }
-            case Encoding::base16: case Encoding::base32: case Encoding::base64:
-            {
-                if (options.encoding.enc == Encoding::base16) {
-                    StringSource(in, in_len, true, new HexDecoder(new StringSinkTemplate<std::basic_string<byte>>(temp)));
-                } else if (options.encoding.enc == Encoding::base32) {
-                    StringSource(in, in_len, true, new Base32Decoder(new StringSinkTemplate<std::basic_string<byte>>(temp)));
-                } else {
-                    StringSource(in, in_len, true, new Base64Decoder(new StringSinkTemplate<std::basic_string<byte>>(temp)));
-                }
-                pEncrypted = temp.c_str();
-                Encrypted_size = temp.size();
-                break;
-            }
+    try {
+        out.iv_size = iv_len;
+        out.tag_size = isAuthenticated() ? intern::tagSize(options.mode) : 0;
+        out.offsets.resize(count + 1);
+        out.offsets[0] = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (!in[i].first || !in[i].second) {
+                throwInvalid("encrypt: invalid input.");
+            }
+            out.offsets[i + 1] = out.offsets[i] + outputSize(in[i].second);
+        }
+        out.data.resize(out.offsets[count]);
+        out.tags.resize(count * out.tag_size);
+        out.ivs.resize(count * iv_len);
+        if (out.ivs.size()) {
+            /* seeded once by the os, instead of one os request per message */
+            AutoSeededRandomPool rng;
+            rng.GenerateBlock(&out.ivs[0], out.ivs.size());
+        }
+
+        size_t threads = intern::batchWorkers(count);
+        size_t range = (count + threads - 1) / threads;
+        std::vector<CipherContext> clones;
+        std::vector<std::thread> workers;
+        std::vector<std::exception_ptr> errors(threads);
+        clones.reserve(threads - 1);
+        workers.reserve(threads - 1);
+        size_t t = 1;
+        try {
+            for (; t < threads && t * range < count; t++) {
+                clones.emplace_back(*this);
+                CipherContext* clone = &clones.back();
+                std::exception_ptr* error = &errors[t];
+                size_t begin = t * range;
+                size_t end = std::min(count, begin + range);
+                workers.emplace_back([=, &out]() {
+                    try {
+                        clone->encryptRange(in, begin, end, out);
+                    } catch (...) {
+                        *error = std::current_exception();
+                    }
+                });
+            }
+        } catch (...) {
+            /* failed to start another thread: the remaining messages are encrypted by this one */
+        }
+        try {
+            encryptRange(in, 0, std::min(count, range), out);
+            if (t < threads && t * range < count) {
+                encryptRange(in, t * range, count, out);
+            }
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+        for (std::thread& w : workers) {
+            w.join();
+        }
+        for (std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
             }
+        }
+    } catch (CryptoPP::Exception& exc) {
+        throwError(exc.GetWhat());
+    } catch (nppcrypt::Exception& exc) {
+        throw exc;
+    } catch (...) {
+        throwError("encrypt: unexpected error.");
+    }
+}
 
-            if (penc->NeedsPrespecifiedDataLengths()) {
-                penc->SpecifyDataLengths(options.aad ? (init.salt.size() + init.iv.size()) : 0, Encrypted_size, 0);
-            }
+void nppcrypt::CipherContext::encryptRange(const std::pair<const byte*, size_t>* in, size_t begin, size_t end, CryptBatch& out)
+{
+    /* every message is encrypted (and encoded) straight into out.data */
+    for (size_t i = begin; i < end; i++) {
+        const byte* iv = iv_len ? &out.ivs[i * iv_len] : NULL;
+        byte* tag = out.tag_size ? &out.tags[i * out.tag_size] : NULL;
+        Output o = { &out.data[out.offsets[i]], NULL };
+        encryptMessage(in[i].first, in[i].second, o, iv, tag);
+    }
+}
 
-            AuthenticatedDecryptionFilter df(*penc, NULL, AuthenticatedDecryptionFilter::MAC_AT_BEGIN | AuthenticatedDecryptionFilter::THROW_EXCEPTION, tag_size);
+void nppcrypt::CipherContext::decrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const InitData& init)
+{
+    using namespace CryptoPP;
 
-            secure_string temp2;
-            df.ChannelPut( DEFAULT_CHANNEL, init.tag.BytePtr(), init.tag.size());
-            if (options.aad) {
-                df.ChannelPut(AAD_CHANNEL, init.salt.BytePtr(), init.salt.size());
-                df.ChannelPut(AAD_CHANNEL, init.iv.BytePtr(), init.iv.size());
-                df.ChannelMessageEnd(AAD_CHANNEL);
-            }
-            df.ChannelPut( DEFAULT_CHANNEL, pEncrypted, Encrypted_size);
-            df.ChannelMessageEnd( DEFAULT_CHANNEL );
+    if (!in || !in_len) {
+        throwInvalid("decrypt: invalid input.");
+    }
 
-            if (!df.GetLastResult()) {
-                throwInfo("decrypt: authentification failed.");
-            }
+    try {
+        const byte* ptVec = decryptionIV(init);
+        size_t tag_size = intern::tagSize(options.mode);
+        if (isAuthenticated() && init.tag.size() != tag_size) {
+            throwInfo("decrypt: authentification failed.");
+        }
+
+        /* no filter chain: ascii input is decrypted to buffer, encoded input is decoded to a scratch buffer first. Never in place:
+           ProcessData() of some ciphers (aria ctr/cfb/gcm/eax/ccm, desx ctr/cfb) is wrong if input and output are the same memory.
+           The plaintext is wiped if the tag or the padding is invalid */
+        size_t offset = buffer.size();
+        plain_string decoded;
+        const byte* pEncrypted;
+        size_t length;
+        switch (options.encoding.enc)
+        {
+        case Encoding::ascii:
+        {
+            buffer.resize(offset + in_len);
+            pEncrypted = in;
+            length = in_len;
+            break;
+        }
+        case Encoding::base16: case Encoding::base32: case Encoding::base64: case Encoding::base85:
+        {
+            /* the decoders accept both cases: the codec of the context serves both directions */
+            decoded.resize(encoder->decodedSize(in_len));
+            buffer.resize(offset + decoded.size());
+            length = encoder->decode(in, in_len, &decoded[0]);
+            pEncrypted = decoded.data();
+            break;
+        }
+        }
+        byte* pDecrypted = &buffer[offset];
 
-            df.SetRetrievalChannel("");
-            size_t n = (size_t)df.MaxRetrievable();
-            buffer.resize(n);
+        if (isAuthenticated()) {
+            AuthenticatedSymmetricCipher& penc = authenticatedCipher(false, ptVec);
+            intern::authenticateInitData(penc, options, salt, ptVec, iv_len, length);
+            penc.ProcessData(pDecrypted, pEncrypted, length);
 
-            if (n > 0) { 
-                df.Get((byte*)buffer.data(), n);
+            if (!penc.TruncatedVerify(init.tag.BytePtr(), tag_size)) {
+                SecureWipeBuffer(pDecrypted, length);
+                buffer.resize(offset);
+                throwInfo("decrypt: authentification failed.");
             }
         } else {
-            std::unique_ptr<SymmetricCipher> pEnc(intern::getSymmetricCipher(options.cipher, options.mode, false));
-            if (!pEnc) {
-                throwError("decrypt: failed to create SymmetricCipher.");
-            }
-            if (iv_len == 0) {
-                pEnc->SetKey(tKey.data(), key_len);
-            } else {
-                pEnc->SetKeyWithIV(tKey.data(), key_len, ptVec, iv_len);
-            }
-
-            switch (options.encoding.enc)
-            {
-            case Encoding::ascii:
-            {
-                StringSource(in, in_len, true, 
-                    new StreamTransformationFilter(*pEnc, 
-                        new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-                break;
-            }
-            case Encoding::base16:
-            {
-                StringSource(in, in_len, true, 
-                    new HexDecoder(
-                        new StreamTransformationFilter(*pEnc, new StringSinkTemplate<std::basic_string<byte>>(buffer))));
-                break;
-            }
-            case Encoding::base32:
-            {
-                StringSource(in, in_len, true,
-                    new Base32Decoder(
-                        new StreamTransformationFilter(*pEnc, new StringSinkTemplate<std::basic_string<byte>>(buffer))
-                    )
-                );
-                break;
-            }
-            case Encoding::base64:
-            {
-                StringSource(in, in_len, true,
-                    new Base64Decoder(
-                        new StreamTransformationFilter(*pEnc, new StringSinkTemplate<std::basic_string<byte>>(buffer))
-                    )
-                );
-                break;
+            size_t padding = intern::paddingBlock(options, block_size);
+            if (padding && (!length || length % padding)) {
+                buffer.resize(offset);
+                throwError("decrypt: ciphertext length is not a multiple of the block size.");
             }
+            symmetricCipher(false, ptVec).ProcessData(pDecrypted, pEncrypted, length);
+            if (padding && !intern::removePadding(pDecrypted, length, padding)) {
+                SecureWipeBuffer(pDecrypted, length);
+                buffer.resize(offset);
+                throwError("decrypt: invalid padding.");
             }
         }
+        buffer.resize(offset + length);
     } catch (CryptoPP::Exception& exc) {
         if (exc.GetErrorType() == CryptoPP::Exception::DATA_INTEGRITY_CHECK_FAILED) {
             throwInfo("decrypt: authentification failed.");
@@ -2007,7 +1875,163 @@ void nppcrypt::decrypt(const byte* in, size_t in_len, std::basic_string<byte>& b
     }
 }
 
+void nppcrypt::CipherContext::encryptInPlace(byte* data, size_t length, InitData& init)
+{
+    using namespace CryptoPP;
+
+    if (!data || !length) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    if (options.encoding.enc != Encoding::ascii || !intern::keepsLength(options)) {
+        throwInvalid("encrypt: in place only without encoding and with stream ciphers or cfb/ofb/ctr/eax/ccm/gcm.");
+    }
+
+    try {
+        const byte* ptVec = encryptionIV(init);
+        checkReuse();
+        if (isAuthenticated()) {
+            AuthenticatedSymmetricCipher& penc = authenticatedCipher(true, ptVec);
+            size_t tag_size = intern::tagSize(options.mode);
+            intern::authenticateInitData(penc, options, salt, ptVec, iv_len, length);
+            intern::processInPlace(penc, data, length);
+
+            byte tag[Constants::tag_size_max];
+            penc.TruncatedFinal(tag, tag_size);
+            init.tag.set(tag, tag_size);
+        } else {
+            intern::processInPlace(symmetricCipher(true, ptVec), data, length);
+        }
+    } catch (CryptoPP::Exception& exc) {
+        throwError(exc.GetWhat());
+    } catch (nppcrypt::Exception& exc) {
+        throw exc;
+    } catch (...) {
+        throwError("encrypt: unexpected error.");
+    }
+}
+
+size_t nppcrypt::CipherContext::decryptInPlace(byte* data, size_t length, const InitData& init)
+{
+    using namespace CryptoPP;
+
+    if (!data || !length) {
+        throwInvalid("decrypt: invalid input.");
+    }
+    if (!intern::keepsLength(options)) {
+        throwInvalid("decrypt: in place only with stream ciphers or cfb/ofb/ctr/eax/ccm/gcm.");
+    }
+
+    try {
+        const byte* ptVec = decryptionIV(init);
+        if (options.encoding.enc != Encoding::ascii) {
+            length = encoder->decodeInPlace(data, length);
+        }
+        if (isAuthenticated()) {
+            size_t tag_size = intern::tagSize(options.mode);
+            if (init.tag.size() != tag_size) {
+                throwInfo("decrypt: authentification failed.");
+            }
+            AuthenticatedSymmetricCipher& penc = authenticatedCipher(false, ptVec);
+            intern::authenticateInitData(penc, options, salt, ptVec, iv_len, length);
+            intern::processInPlace(penc, data, length);
+
+            if (!penc.TruncatedVerify(init.tag.BytePtr(), tag_size)) {
+                /* gcm, ccm and eax xor a key stream: encrypting the plaintext again restores the ciphertext. The message is
+                   finished, or the mac of eax would carry it into the next one (Resynchronize() does not restart it) */
+                AuthenticatedSymmetricCipher& prestore = authenticatedCipher(true, ptVec);
+                intern::authenticateInitData(prestore, options, salt, ptVec, iv_len, length);
+                intern::processInPlace(prestore, data, length);
+                byte tag[Constants::tag_size_max];
+                prestore.TruncatedFinal(tag, tag_size);
+                throwInfo("decrypt: authentification failed.");
+            }
+        } else {
+            intern::processInPlace(symmetricCipher(false, ptVec), data, length);
+        }
+    } catch (CryptoPP::Exception& exc) {
+        throwError(exc.GetWhat());
+    } catch (nppcrypt::Exception& exc) {
+        throw exc;
+    } catch (...) {
+        throwError("decrypt: unexpected error.");
+    }
+    return length;
+}
+
+void nppcrypt::encrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    if (!in || !in_len) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    intern::createSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    context.encrypt(in, in_len, buffer, init);
+}
+
+void nppcrypt::encrypt(const byte* in, size_t in_len, SegmentedBuffer& buffer, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    if (!in || !in_len) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    intern::createSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    context.encrypt(in, in_len, buffer, init);
+}
+
+void nppcrypt::encrypt(const std::pair<const byte*, size_t>* in, size_t count, CryptBatch& out, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    intern::createSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    context.encrypt(in, count, out);
+}
+
+void nppcrypt::decrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    if (!in || !in_len) {
+        throwInvalid("decrypt: invalid input.");
+    }
+    intern::checkSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    context.decrypt(in, in_len, buffer, init);
+}
+
+void nppcrypt::encryptInPlace(byte* data, size_t length, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    if (!data || !length) {
+        throwInvalid("encrypt: invalid input.");
+    }
+    intern::createSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    context.encryptInPlace(data, length, init);
+}
+
+size_t nppcrypt::decryptInPlace(byte* data, size_t length, const Options::Crypt& options, const UserData& password, InitData& init)
+{
+    if (!data || !length) {
+        throwInvalid("decrypt: invalid input.");
+    }
+    intern::checkSalt(options, init);
+    CipherContext context(options, password, init.salt);
+    return context.decryptInPlace(data, length, init);
+}
+
 void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, std::initializer_list<std::pair<const byte*, size_t>> in)
+{
+    intern::hashPieces(options, buffer, in.begin(), in.size());
+}
+
+void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, const byte* prefix, size_t prefix_len, const SegmentedBuffer& in)
+{
+    std::vector<std::pair<const byte*, size_t>> pieces;
+    pieces.reserve(in.segments() + 1);
+    pieces.push_back(std::make_pair(prefix, prefix_len));
+    for (size_t i = 0; i < in.segments(); i++) {
+        pieces.push_back(std::make_pair(in.segment(i), in.segmentSize(i)));
+    }
+    intern::hashPieces(options, buffer, pieces.data(), pieces.size());
+}
+
+void intern::hashPieces(Options::Hash& options, std::basic_string<byte>& buffer, const std::pair<const byte*, size_t>* in, size_t count)
 {
     try {
         using namespace CryptoPP;
@@ -2020,39 +2044,39 @@ void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, std
         if (keylength != 0 && options.use_key && options.key.size() != keylength) {
             throwInvalid("hash: invalid key-length.");
         }
+        if (!options.use_key) {
+            for (size_t i = 0; i < sizeof(intern::hash_pipelines) / sizeof(intern::hash_pipelines[0]); i++) {
+                if (intern::hash_pipelines[i].algorithm == options.algorithm && intern::hash_pipelines[i].digest_length == options.digest_length
+                    && intern::hash_pipelines[i].encoding == options.encoding) {
+                    intern::hash_pipelines[i].pipeline(in, count, buffer);
+                    return;
+                }
+            }
+        }
 
-        SecByteBlock digest;
+        plain_string digest;
         std::unique_ptr<HashTransformation> phash(intern::getHashTransformation(options));
         if (!phash) {
             throwError("hash: failed to create HashTransformation.");
         }
         digest.resize(phash->DigestSize());
-        for (const std::pair<const byte*, size_t>& i : in) {
-            phash->Update(i.first, i.second);
+        for (size_t i = 0; i < count; i++) {
+            phash->Update(in[i].first, in[i].second);
         }
-        phash->Final(digest);
+        phash->Final(&digest[0]);
 
         buffer.clear();
         switch (options.encoding)
         {
         case nppcrypt::Encoding::ascii:
         {
-            buffer.assign(digest.begin(), digest.end());
-            break;
-        }
-        case nppcrypt::Encoding::base16:
-        {
-            StringSource(&digest[0], digest.size(), true, new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-            break;
-        }
-        case nppcrypt::Encoding::base32:
-        {
-            StringSource(&digest[0], digest.size(), true, new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
+            buffer = digest;
             break;
         }
-        case nppcrypt::Encoding::base64:
+        default:
         {
-            StringSource(&digest[0], digest.size(), true, new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
+            std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.encoding));
+            encoder->encode(&digest[0], digest.size(), buffer);
             break;
         }
         }
@@ -2067,39 +2091,115 @@ void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, con
         using namespace CryptoPP;
         using namespace std;
 
-        SecByteBlock digest;
+        plain_string digest;
         std::unique_ptr<HashTransformation> phash(intern::getHashTransformation(options));
         if (!phash) {
             throwError("hash: failed to create HashTransformation.");
         }
         digest.resize(phash->DigestSize());
 
-        FileSource f(path.c_str(), true, new HashFilter(*phash, new ArraySink(digest, digest.size())));
+        std::ifstream file;
+        std::unique_ptr<byte[]> chunk(new byte[Constants::hash_file_chunk]);
+        intern::hashFile(*phash, file, path, chunk.get(), &digest[0]);
 
         buffer.clear();
         switch (options.encoding)
         {
         case nppcrypt::Encoding::ascii:
         {
-            buffer.assign(digest.begin(), digest.end());
+            buffer = digest;
             break;
         }
-        case nppcrypt::Encoding::base16:
+        default:
         {
-            StringSource(&digest[0], digest.size(), true, new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
+            std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.encoding));
+            encoder->encode(&digest[0], digest.size(), buffer);
             break;
         }
-        case nppcrypt::Encoding::base32:
-        {
-            StringSource(&digest[0], digest.size(), true, new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-            break;
         }
-        case nppcrypt::Encoding::base64:
-        {
-            StringSource(&digest[0], digest.size(), true, new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-            break;
+    } catch (...) {
+        throwError("hash: unexpected error.");
+    }
+}
+
+void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, const std::pair<const byte*, size_t>* in, size_t count)
+{
+    try {
+        using namespace CryptoPP;
+
+        size_t keylength;
+        if (!getHashInfo(options.algorithm, options.digest_length, keylength)) {
+            throwInvalid("hash: invalid algorithm.");
         }
+        if (keylength != 0 && options.use_key && options.key.size() != keylength) {
+            throwInvalid("hash: invalid key-length.");
+        }
+
+        multibuffer::Algorithm mb;
+        if (!options.use_key && (options.algorithm == Hash::sha3 || options.algorithm == Hash::keccak)) {
+            buffer.resize(count * options.digest_length);
+            if (count) {
+                keccak::batch(in, count, 200 - 2 * options.digest_length, (options.algorithm == Hash::sha3) ? 0x06 : 0x01, &buffer[0], options.digest_length);
+            }
+        } else if (intern::getMultiBufferAlgorithm(options, mb)) {
+            buffer.resize(count * options.digest_length);
+            if (count) {
+                multibuffer::hash(mb, in, count, &buffer[0]);
+            }
+        } else {
+            std::unique_ptr<HashTransformation> phash(intern::getHashTransformation(options));
+            if (!phash) {
+                throwError("hash: failed to create HashTransformation.");
+            }
+            size_t digest_length = phash->DigestSize();
+            buffer.resize(count * digest_length);
+            for (size_t i = 0; i < count; i++) {
+                phash->Update(in[i].first, in[i].second);
+                phash->Final(&buffer[i * digest_length]);
+            }
         }
+    } catch (nppcrypt::Exception& exc) {
+        throw exc;
+    } catch (...) {
+        throwError("hash: unexpected error.");
+    }
+}
+
+void nppcrypt::hash(Options::Hash& options, std::basic_string<byte>& buffer, const std::vector<std::string>& paths)
+{
+    try {
+        using namespace CryptoPP;
+
+        size_t keylength;
+        if (!getHashInfo(options.algorithm, options.digest_length, keylength)) {
+            throwInvalid("hash: invalid algorithm.");
+        }
+        if (keylength != 0 && options.use_key && options.key.size() != keylength) {
+            throwInvalid("hash: invalid key-length.");
+        }
+
+        multibuffer::Algorithm mb;
+        if (intern::getMultiBufferAlgorithm(options, mb)) {
+            buffer.resize(paths.size() * options.digest_length);
+            if (paths.size()) {
+                intern::MultiBufferFiles files(paths);
+                multibuffer::hash(mb, files, paths.size(), &buffer[0]);
+            }
+        } else {
+            std::unique_ptr<HashTransformation> phash(intern::getHashTransformation(options));
+            if (!phash) {
+                throwError("hash: failed to create HashTransformation.");
+            }
+            size_t digest_length = phash->DigestSize();
+            buffer.resize(paths.size() * digest_length);
+            std::ifstream file;
+            std::unique_ptr<byte[]> chunk(new byte[Constants::hash_file_chunk]);
+            for (size_t i = 0; i < paths.size(); i++) {
+                intern::hashFile(*phash, file, paths[i], chunk.get(), &buffer[i * digest_length]);
+            }
+        }
+    } catch (nppcrypt::Exception& exc) {
+        throw exc;
     } catch (...) {
         throwError("hash: unexpected error.");
     }
@@ -2122,122 +2222,88 @@ void nppcrypt::shake128(const byte* in, size_t in_len, byte* out, size_t out_len
     }
 }
 
-void nppcrypt::convert(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Convert& options, const EncodingAlphabet* base32_alphabet, const EncodingAlphabet* base64_alphabet)
+void nppcrypt::convert(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Convert& options, const EncodingAlphabet* base32_alphabet, const EncodingAlphabet* base64_alphabet, const EncodingAlphabet* base85_alphabet)
 {
-    using namespace CryptoPP;
     using namespace nppcrypt;
 
     const std::string& s_eol = Strings::eol[(unsigned)options.eol];
     int linelength = options.linebreaks ? (int)options.linelength : 0;
-    const byte* base32_uppercase = NULL;
-    const byte* base32_lowercase = NULL;
-    byte        base32_padding = 0;
-    const int*  base32_lookup = NULL;
-    const byte* base64_alpha = NULL;
-    const int*  base64_lookup = NULL;
-    byte        base64_padding = 0;
-
-    if (base32_alphabet) {
-        base32_uppercase = base32_alphabet->c_str(true);
-        base32_lowercase = base32_alphabet->c_str(false);
-        base32_padding = base32_alphabet->getPadding();
-        base32_lookup = base32_alphabet->getLookup();
-    }
-    if (base64_alphabet) {
-        base64_alpha = base64_alphabet->c_str();
-        base64_lookup = base64_alphabet->getLookup();
-        base64_padding = base64_alphabet->getPadding();
-    }
-
-    switch (options.from)
-    {
-    case Encoding::ascii:
-    {
-        switch (options.to)
-        {
-        case Encoding::base16:
-        {
-            StringSource(in, in_len, true, new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol));
-            break;
-        }
-        case Encoding::base32:
-        {
-            StringSource(in, in_len, true, new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol, base32_padding, base32_lowercase, base32_uppercase));
-            break;
-        }
-        case Encoding::base64:
-        {
-            StringSource(in, in_len, true, new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), linelength, s_eol, base64_padding, base64_alpha));
-            break;
-        }
-        }
-        break;
+    const EncodingAlphabet* alphabets[] = { NULL, NULL, base32_alphabet, base64_alphabet, base85_alphabet };
+
+    if (options.from == options.to) {
+        return;
     }
-    case Encoding::base16:
-    {
-        switch (options.to)
-        {
-        case Encoding::ascii:
-        {
-            StringSource(in, in_len, true, new HexDecoder(new StringSinkTemplate<std::basic_string<byte>>(buffer)));
-            break;
-        }
-        case Encoding::base32:
-        {
-            StringSource(in, in_len, true, new HexDecoder(new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol, base32_padding, base32_lowercase, base32_uppercase)));
-            break;
-        }
-        case Encoding::base64:
-        {
-            StringSource(in, in_len, true, new HexDecoder(new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), linelength, s_eol, base64_padding, base64_alpha)));
-            break;
-        }
-        }
-        break;
+    std::basic_string<byte> temp;
+    if (options.from != Encoding::ascii) {
+        std::unique_ptr<codec::Codec> decoder(intern::getCodec(options.from, true, alphabets[(unsigned)options.from]));
+        if (options.to == Encoding::ascii) {
+            decoder->decode(in, in_len, buffer);
+            return;
+        }
+        decoder->decode(in, in_len, temp);
+        in = temp.data();
+        in_len = temp.size();
     }
-    case Encoding::base32:
-    {
-        switch (options.to)
-        {
-        case Encoding::ascii:
-        {
-            StringSource(in, in_len, true, new Base32Decoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), base32_lookup));
-            break;
-        }
-        case Encoding::base16:
-        {
-            StringSource(in, in_len, true, new Base32Decoder(new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol), base32_lookup));
-            break;
-        }
-        case Encoding::base64:
-        {
-            StringSource(in, in_len, true, new Base32Decoder(new Base64Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), linelength, s_eol, base64_padding, base64_alpha), base32_lookup));
-            break;
-        }
-        }
-        break;
+    std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.to, options.uppercase, alphabets[(unsigned)options.to]));
+    encoder->encode(in, in_len, buffer, linelength, s_eol);
+}
+
+void nppcrypt::convert(std::istream& in, std::ostream& out, const Options::Convert& options, const EncodingAlphabet* base32_alphabet, const EncodingAlphabet* base64_alphabet, const EncodingAlphabet* base85_alphabet)
+{
+    using namespace nppcrypt;
+
+    const std::string& s_eol = Strings::eol[(unsigned)options.eol];
+    size_t linelength = options.linebreaks ? options.linelength : 0;
+    const EncodingAlphabet* alphabets[] = { NULL, NULL, base32_alphabet, base64_alphabet, base85_alphabet };
+
+    if (options.from == options.to) {
+        return;
     }
-    case Encoding::base64:
-    {
-        switch (options.to)
-        {
-        case Encoding::ascii:
-        {
-            StringSource(in, in_len, true, new Base64Decoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), base64_lookup));
-            break;
-        }
-        case Encoding::base16:
-        {
-            StringSource(in, in_len, true, new Base64Decoder(new HexEncoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol), base64_lookup));
-            break;
-        }
-        case Encoding::base32:
-        {
-            StringSource(in, in_len, true, new Base64Decoder(new Base32Encoder(new StringSinkTemplate<std::basic_string<byte>>(buffer), options.uppercase, linelength, s_eol, base32_padding, base32_lowercase, base32_uppercase), base64_lookup));
-            break;
+    std::unique_ptr<codec::Codec> decoder(intern::getCodec(options.from, true, alphabets[(unsigned)options.from]));
+    std::unique_ptr<codec::Codec> encoder(intern::getCodec(options.to, options.uppercase, alphabets[(unsigned)options.to]));
+    size_t unit = encoder ? encoder->lineBytes(linelength) : 1;
+
+    /* chars: input characters, the incomplete last group is kept for the next chunk.
+       data: bytes to encode, the rest of the last unit is kept. text: encoded chunk */
+    std::basic_string<byte> chars, data, text;
+    std::basic_string<byte>& source = decoder ? chars : data;
+    bool started = false;
+    bool end = false;
+
+    while (!end) {
+        size_t offset = source.size();
+        source.resize(offset + Constants::convert_chunk);
+        in.read((char*)&source[offset], (std::streamsize)Constants::convert_chunk);
+        if (in.bad()) {
+            throwError("convert: failed to read input.");
+        }
+        source.resize(offset + (size_t)in.gcount());
+        end = in.eof();
+
+        if (decoder) {
+            size_t length = end ? chars.size() : decoder->groupsLength(chars.data(), chars.size());
+            decoder->decode(chars.data(), length, data);
+            chars.erase(0, length);
+        }
+        size_t length = end ? data.size() : data.size() / unit * unit;
+        if (!length) {
+            continue;
+        }
+        if (encoder) {
+            text.clear();
+            if (started && linelength) {
+                /* the previous chunk ended with a whole line */
+                text.assign(s_eol.begin(), s_eol.end());
+            }
+            encoder->encode(data.data(), length, text, linelength, s_eol);
+            out.write((const char*)text.data(), (std::streamsize)text.size());
+        } else {
+            out.write((const char*)data.data(), (std::streamsize)length);
         }
+        if (out.bad()) {
+            throwError("convert: failed to write output.");
         }
-        break;
-    }
+        data.erase(0, length);
+        started = true;
     }
 }
\ No newline at end of file
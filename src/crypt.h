@@ -17,13 +17,22 @@ GNU General Public License for more details.
 #define CRYPT_H_DEF
 
 #include <string>
+#include <vector>
+#include <iosfwd>
+#include <memory>
+#include <atomic>
 #include "cryptopp/secblock.h"
+#include "arena.h"
 
 namespace nppcrypt
 {
     typedef CryptoPP::byte byte;
-    typedef std::basic_string<char, std::char_traits<char>, CryptoPP::AllocatorWithCleanup<char> > secure_string;
-    typedef std::basic_string<wchar_t, std::char_traits<wchar_t>, CryptoPP::AllocatorWithCleanup<wchar_t> > secure_wstring;
+    /* passwords and key material: locked memory of the secure arena, wiped on release ( see arena.h ) */
+    typedef std::basic_string<char, std::char_traits<char>, arena::Allocator<char> > secure_string;
+    typedef CryptoPP::SecBlock<byte, arena::Allocator<byte> > secure_block;
+    /* ciphertext, encoded text, headers and digests are public: plain heap memory that is neither locked nor wiped when it is freed or grows */
+    typedef std::basic_string<byte> plain_string;
+    typedef std::basic_string<wchar_t, std::char_traits<wchar_t>, arena::Allocator<wchar_t> > secure_wstring;
 
     enum class Cipher : unsigned {
         threeway, aria, blowfish, camellia, cast128, cast256, chacha20, des, des_ede2, des_ede3, desx, gost, idea, kalyna128, kalyna256, kalyna512, mars, panama, rc2, rc4, rc5, rc6, rijndael, saferk, safersk, salsa20, seal, seed, serpent, shacal2, shark, simon128, skipjack, sm4, sosemanuk, speck128, square, tea, threefish256, threefish512, threefish1024, twofish, wake, xsalsa20, xtea, COUNT
@@ -34,11 +43,11 @@ namespace nppcrypt
     };
 
     enum class Hash: unsigned {
-        adler32, blake2b, blake2s, cmac_aes, crc32, keccak, md2, md4, md5, ripemd, sha1, sha2, sha3, siphash24, siphash48, sm3, tiger, whirlpool, COUNT
+        adler32, blake2b, blake2s, cmac_aes, crc32, crc32c, keccak, md2, md4, md5, parallelhash128, parallelhash256, ripemd, sha1, sha2, sha3, siphash24, siphash48, sm3, tiger, whirlpool, xxh3, COUNT
     };
 
     enum class Encoding : unsigned {
-        ascii, base16, base32, base64, COUNT
+        ascii, base16, base32, base64, base85, COUNT
     };
 
     enum class EOL : unsigned { 
@@ -79,6 +88,22 @@ namespace nppcrypt
         const int gcm_tag_size = 16;                /* gcm tag size in bytes */
         const int ccm_tag_size = 16;                /* ccm tag size in bytes */
         const int eax_tag_size = 16;                /* eax tag size in bytes */
+        const int tag_size_max = 16;                /* largest of the tag sizes above */
+        const int block_size_max = 128;             /* largest block size (threefish1024) */
+        const size_t parallelhash_blocksize = 8192; /* parallelhash: block size B in bytes */
+        const size_t parallelhash_batch = 64;       /* parallelhash: blocks buffered before they are hashed */
+        const size_t parallelhash_thread_min = 32;  /* parallelhash: min blocks per worker thread */
+        const size_t codec_thread_min = 1 << 20;    /* base16/32/64/85: min input bytes per worker thread */
+        const size_t convert_chunk = 1 << 22;       /* convert (streams): bytes read at once */
+        const size_t hash_file_chunk = 1 << 16;     /* hash (files): bytes read at once */
+        const size_t crypt_chunk = 1 << 18;         /* encrypt/decrypt: bytes encrypted at once before they are encoded */
+        const size_t crypt_stack = 512;             /* encrypt: messages up to this size are encrypted on the stack before they are encoded */
+        const size_t crypt_inplace = 1 << 12;       /* encryptInPlace/decryptInPlace: bytes staged at once through a stack buffer */
+        const size_t batch_thread_min = 1024;       /* encrypt (batch): min messages per worker thread */
+        const size_t arena_chunk = 1 << 16;         /* secure arena: bytes mapped (and locked) at once */
+        const size_t arena_class_max = 4096;        /* secure arena: largest block of the size classes, larger ones are mapped on their own */
+        const size_t segment_size = 1 << 20;        /* SegmentedBuffer: bytes per chunk */
+        const size_t segment_pool = 16;             /* SegmentedBuffer: free chunks kept for reuse */
     };
 
     /* ---------------------------------------------------------------------------------------------------------------------------------- */
@@ -140,7 +165,7 @@ namespace nppcrypt
         void            clear();
 
     private:
-        CryptoPP::SecByteBlock data;
+        secure_block    data;
     };
 
     /* ---------------------------------------------------------------------------------------------------------------------------------- */
@@ -154,7 +179,7 @@ namespace nppcrypt
     };
 
     /* ---------------------------------------------------------------------------------------------------------------------------------- */
-    /* used by convert() to receive custom base32/64 alphabets */
+    /* used by convert() to receive custom base32/64/85 alphabets */
 
     class EncodingAlphabet
     {
@@ -221,6 +246,7 @@ namespace nppcrypt
             nppcrypt::Encoding         encoding;
             bool                    use_key;
             UserData                key;
+            std::string             customization;  /* cSHAKE customization string S (parallelhash) */
         };
 
         struct Convert
@@ -236,16 +262,183 @@ namespace nppcrypt
         };
     };
 
+    /* ---------------------------------------------------------------------------------------------------------------------------------- */
+    /* used by encrypt() to return a batch of messages: message i is data[offsets[i]] ... data[offsets[i + 1] - 1],
+       its iv starts at ivs[i * iv_size], its tag at tags[i * tag_size] (sizes 0: none). All messages share the salt */
+
+    struct CryptBatch
+    {
+        CryptBatch() : iv_size(0), tag_size(0) {};
+        plain_string                data;
+        std::vector<size_t>         offsets;
+        plain_string                ivs;
+        size_t                      iv_size;
+        plain_string                tags;
+        size_t                      tag_size;
+    };
+
+    /* ---------------------------------------------------------------------------------------------------------------------------------- */
+    /* output of encrypt() in segments: chunks of Constants::segment_size bytes from a pool shared by all buffers. It grows without
+       reallocating or copying, the segments are written with writev() (see clihelp.h) or copied out */
+
+    class SegmentedBuffer
+    {
+    public:
+        SegmentedBuffer() : length(0) {};
+        SegmentedBuffer(const SegmentedBuffer&) = delete;
+        SegmentedBuffer& operator = (const SegmentedBuffer&) = delete;
+        ~SegmentedBuffer();
+
+        /* n contiguous bytes at the end: in the last chunk if they fit, else in the next one (a block of its own if n > segment_size) */
+        byte*           append(size_t n);
+        void            append(const byte* data, size_t n);
+        /* returns the chunks to the pool */
+        void            clear();
+        size_t          size() const { return length; };
+        size_t          segments() const { return parts.size(); };
+        const byte*     segment(size_t i) const { return parts[i].data; };
+        size_t          segmentSize(size_t i) const { return parts[i].size; };
+        /* appends all segments to out */
+        void            copy(plain_string& out) const;
+
+    private:
+        struct Part
+        {
+            byte*   data;
+            size_t  size;
+            size_t  capacity;
+        };
+        std::vector<Part>   parts;
+        size_t              length;
+    };
+
+    namespace codec
+    {
+        class Codec;
+    };
+
+    /* ---------------------------------------------------------------------------------------------------------------------------------- */
+    /* one derived key for many messages: the cipher objects (key schedule, gcm tables, key dependent s-boxes) are created on first use,
+       every further message only resynchronizes them with its iv. Not thread-safe: copies are independent contexts that share nothing
+       but the derived key (no second key derivation), one per thread */
+
+    class CipherContext
+    {
+    public:
+        /* derives the key (and the iv if options.iv is keyderivation) from password and salt */
+        CipherContext(const Options::Crypt& options, const UserData& password, const UserData& salt);
+        CipherContext(const CipherContext& other);
+        CipherContext& operator = (const CipherContext&) = delete;
+        ~CipherContext();
+
+        /* see nppcrypt::encrypt(): init.salt is set to the salt of the context, init.iv according to options.iv.
+           A second message (of the context or of a copy, encryptInPlace() included) needs random ivs: with a fixed iv (keyderivation,
+           zero, custom) or without one (rc4, wake, ecb) it would be encrypted under the same key stream */
+        void            encrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, InitData& init);
+        void            encrypt(const byte* in, size_t in_len, SegmentedBuffer& buffer, InitData& init);
+        /* count messages in[i], none of them empty (as encrypt() and decrypt() of a single message).
+           The cipher needs an iv (not rc4, wake or ecb) and options.iv has to be random: the ivs come from one generator seeded once. Large batches are split among copies of the context on worker threads */
+        void            encrypt(const std::pair<const byte*, size_t>* in, size_t count, CryptBatch& out);
+        /* see nppcrypt::decrypt(): the iv of init is used, the derived one if init.iv is empty and options.iv is keyderivation.
+           options.aad authenticates the salt of the context (the one of the key), init.salt is not read */
+        void            decrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const InitData& init);
+        void            encryptInPlace(byte* data, size_t length, InitData& init);
+        size_t          decryptInPlace(byte* data, size_t length, const InitData& init);
+
+        const Options::Crypt&   getOptions() const { return options; };
+        const UserData&         getSalt() const { return salt; };
+
+    private:
+        /* where encryptWith() writes to: contiguous memory of outputSize() bytes, or the end of a SegmentedBuffer */
+        struct Output
+        {
+            byte*               next;
+            SegmentedBuffer*    segments;
+
+            byte* take(size_t n)
+            {
+                if (segments) {
+                    return segments->append(n);
+                }
+                byte* p = next;
+                next += n;
+                return p;
+            };
+        };
+
+        bool            isAuthenticated() const;
+        /* throws if the key encrypted a message already and the next one would reuse its iv */
+        void            checkReuse();
+        const byte*     encryptionIV(InitData& init) const;
+        const byte*     decryptionIV(const InitData& init) const;
+        /* the cipher object of the direction, keyed on first use, resynchronized with iv afterwards */
+        CryptoPP::SymmetricCipher&              symmetricCipher(bool encryption, const byte* iv);
+        CryptoPP::AuthenticatedSymmetricCipher& authenticatedCipher(bool encryption, const byte* iv);
+        void            setKey(CryptoPP::SimpleKeyingInterface& cipher, bool created, const byte* iv) const;
+        /* encrypt() after the checks, with exception translation */
+        void            encryptTo(const byte* in, size_t in_len, Output& out, InitData& init);
+        /* encrypt() without checks and exception translation: outputSize(in_len) bytes to out, the tag to tag if authenticated */
+        void            encryptMessage(const byte* in, size_t in_len, Output& out, const byte* ptVec, byte* tag);
+        /* nppcrypt::encryptedSize() with the codec and block size of the context */
+        size_t          outputSize(size_t in_len) const;
+        /* messages begin ... end - 1 of a batch, out is sized already */
+        void            encryptRange(const std::pair<const byte*, size_t>* in, size_t begin, size_t end, CryptBatch& out);
+        /* encryptMessage() after keying: cipher is an object of the class C, its ProcessData() calls are bound statically
+           unless C is StreamTransformation (the generic pipeline, see CipherContext()) */
+        template<class C> void  encryptWith(CryptoPP::StreamTransformation& cipher, const byte* in, size_t in_len, Output& out, size_t padding);
+
+        typedef void (CipherContext::*Pipeline)(CryptoPP::StreamTransformation&, const byte*, size_t, Output&, size_t);
+
+        Options::Crypt          options;
+        UserData                salt;
+        secure_block            key;
+        size_t                  key_len;
+        size_t                  iv_len;
+        size_t                  block_size;
+        Pipeline                pipeline;
+        /* codec of options.encoding, NULL: ascii */
+        std::unique_ptr<codec::Codec>                           encoder;
+        /* set by the first message, shared with the copies: they encrypt under the same key */
+        std::shared_ptr<std::atomic<bool>>                      encrypted;
+        /* [0]: decryption, [1]: encryption */
+        std::unique_ptr<CryptoPP::SymmetricCipher>              sym[2];
+        std::unique_ptr<CryptoPP::AuthenticatedSymmetricCipher> aead[2];
+    };
+
     /* ---------------------------------------------------------------------------------------------------------------------------------- */
     
     bool getCipherInfo(nppcrypt::Cipher cipher, nppcrypt::Mode mode, size_t& key_length, size_t& iv_length, size_t& block_size);
     bool getHashInfo(Hash h, size_t& length, size_t& keylength);
+    /* exact length of the encrypt() output for in_len bytes (without header and tag) */
+    size_t encryptedSize(size_t in_len, const Options::Crypt& options);
+    /* upper bound of the decrypt() output for in_len bytes of (encoded) input */
+    size_t decryptedSize(size_t in_len, const Options::Crypt& options);
+    /* length of the convert() output: exact if options.from is ascii, an upper bound otherwise */
+    size_t convertedSize(size_t in_len, const Options::Convert& options, const EncodingAlphabet* base32_alphabet = NULL, const EncodingAlphabet* base64_alphabet = NULL, const EncodingAlphabet* base85_alphabet = NULL);
     void encrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init);
+    /* appends to buffer: large outputs without one contiguous block */
+    void encrypt(const byte* in, size_t in_len, SegmentedBuffer& buffer, const Options::Crypt& options, const UserData& password, InitData& init);
+    /* count messages under one key (see CipherContext::encrypt()), the salt is returned in init */
+    void encrypt(const std::pair<const byte*, size_t>* in, size_t count, CryptBatch& out, const Options::Crypt& options, const UserData& password, InitData& init);
     void decrypt(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Crypt& options, const UserData& password, InitData& init);
+    /* in place, ascii encoding and ciphers that keep the length only: every stream cipher, every block cipher in cfb/ofb/ctr mode and
+       the 128 bit block ciphers in eax/ccm/gcm mode. The tag is returned in init */
+    void encryptInPlace(byte* data, size_t length, const Options::Crypt& options, const UserData& password, InitData& init);
+    /* in place, encoded data is decoded in place first. Returns the length of the plaintext at data.
+       If authentication fails data holds the (decoded) ciphertext again */
+    size_t decryptInPlace(byte* data, size_t length, const Options::Crypt& options, const UserData& password, InitData& init);
     void hash(Options::Hash& options, std::basic_string<byte>& buffer, std::initializer_list<std::pair<const byte*, size_t>> in);
+    /* digest of prefix followed by the segments of in */
+    void hash(Options::Hash& options, std::basic_string<byte>& buffer, const byte* prefix, size_t prefix_len, const SegmentedBuffer& in);
     void hash(Options::Hash& options, std::basic_string<byte>& buffer, const std::string& path);
+    /* digests of count independent inputs, written consecutively to buffer ( count * digest_length bytes, encoding is ignored ) */
+    void hash(Options::Hash& options, std::basic_string<byte>& buffer, const std::pair<const byte*, size_t>* in, size_t count);
+    /* digests of the files in paths, written consecutively to buffer ( paths.size() * digest_length bytes, encoding is ignored ) */
+    void hash(Options::Hash& options, std::basic_string<byte>& buffer, const std::vector<std::string>& paths);
     void shake128(const byte* in, size_t in_len, byte* out, size_t out_len);
-    void convert(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Convert& options, const EncodingAlphabet* base32_alphabet = NULL, const EncodingAlphabet* base64_alphabet = NULL);
+    void convert(const byte* in, size_t in_len, std::basic_string<byte>& buffer, const Options::Convert& options, const EncodingAlphabet* base32_alphabet = NULL, const EncodingAlphabet* base64_alphabet = NULL, const EncodingAlphabet* base85_alphabet = NULL);
+    /* in to out in chunks of Constants::convert_chunk bytes, the output equals convert() of the whole input */
+    void convert(std::istream& in, std::ostream& out, const Options::Convert& options, const EncodingAlphabet* base32_alphabet = NULL, const EncodingAlphabet* base64_alphabet = NULL, const EncodingAlphabet* base85_alphabet = NULL);
 };
 
 #endif
@@ -143,10 +143,13 @@ static const unsigned int hash_properties[unsigned(nppcrypt::Hash::COUNT)] =
     /* blake2s          */ KEY_SUPPORT,
     /* cmac_aes         */ KEY_SUPPORT | KEY_REQUIRED,
     /* crc32            */ WEAK,
+    /* crc32c           */ WEAK,
     /* keccak           */ HMAC_SUPPORT,
     /* md2              */ HMAC_SUPPORT | WEAK,
     /* md4              */ HMAC_SUPPORT | WEAK,
     /* md5              */ HMAC_SUPPORT | WEAK,
+    /* parallelhash128  */ 0,
+    /* parallelhash256  */ 0,
     /* ripemd           */ HMAC_SUPPORT,
     /* sha1             */ HMAC_SUPPORT | WEAK,
     /* sha2             */ HMAC_SUPPORT,
@@ -155,7 +158,8 @@ static const unsigned int hash_properties[unsigned(nppcrypt::Hash::COUNT)] =
     /* siphash48        */ KEY_SUPPORT | KEY_REQUIRED,
     /* sm3              */ HMAC_SUPPORT,
     /* tiger            */ HMAC_SUPPORT,
-    /* whirlpool        */ HMAC_SUPPORT
+    /* whirlpool        */ HMAC_SUPPORT,
+    /* xxh3             */ WEAK
 };
 
 static const unsigned int hash_digests[unsigned(nppcrypt::Hash::COUNT)] =
@@ -165,10 +169,13 @@ static const unsigned int hash_digests[unsigned(nppcrypt::Hash::COUNT)] =
     /* blake2s          */ B16 | B32,
     /* cmac_aes         */ B16,
     /* crc32            */ B4,
+    /* crc32c           */ B4,
     /* keccak           */ B28 | B32 | B48 | B64,
     /* md2              */ B16,
     /* md4              */ B16,
     /* md5              */ B16,
+    /* parallelhash128  */ B16 | B32 | B48 | B64,
+    /* parallelhash256  */ B16 | B32 | B48 | B64,
     /* ripemd           */ B16 | B20 | B32 | B40,
     /* sha1             */ B20,
     /* sha2             */ B28 | B32 | B48 | B64,
@@ -178,6 +185,7 @@ static const unsigned int hash_digests[unsigned(nppcrypt::Hash::COUNT)] =
     /* sm3              */ B32,
     /* tiger            */ B24,
     /* whirlpool        */ B64,
+    /* xxh3             */ B8 | B16,
 };
 
 /* { startindex , endindex } of nppcrypt::Cipher */
@@ -205,14 +213,14 @@ namespace Strings {
     static const char*  iv[] = { "random", "keyderivation", "zero", "custom" };
     static const char*  iv_help[] = { "Win32:CryptGenRandom() is used", "use keyderivation to create Key + IV", "use zero vector", "user specified IV" };
 
-    static const char*  hash[] = { "adler32", "blake2b", "blake2s", "cmac_aes", "crc32", "keccak", "md2", "md4", "md5", "ripemd", "sha1", "sha2", "sha3", "siphash24", "siphash48", "sm3", "tiger", "whirlpool" };
-    static const char*  hash_label[] = { "Adler-32", "BLAKE2b", "BLAKE2s", "CMAC<AES>", "CRC-32", "Keccak", "MD2", "MD4", "MD5", "RIPEMD", "SHA-1", "SHA-2", "SHA-3", "SipHash-2-4", "SipHash-4-8", "SM3", "Tiger", "Whirlpool" };
-    static const char*  hash_info_url[] = { "Adler-32","BLAKE_(hash_function)#BLAKE2", "BLAKE_(hash_function)#BLAKE2", "One-key_MAC", "Cyclic_redundancy_check", "SHA-3", "MD2_(cryptography)", "MD4", "MD5", "RIPEMD", "SHA-1", "SHA-2", "SHA-3", "SipHash", "SipHash", "SM3", "Tiger_(cryptography)", "Whirlpool_(cryptography)" };
-    static const char*  hash_info[] = { "non-cryptographic checksum; Mark Adler, 1995", "Aumasson, Neves, O'Hearn, Winnerlein, 2012", "Aumasson, Neves, O'Hearn, Winnerlein, 2012", "fixed keylength of 16 bytes", "non-cryptographic checksum, polynomial: 0xEDB88320; Peterson, 1961", "f1600 with XOF d=0x01 (see SHA-3); Bertoni, Daemen, Peeters, Van Assche, 2015", "Ronald Rivest, 1989", "Ronald Rivest, 1990", "Ronald Rivest, 1992", "Dobbertin, Bosselaers, Preneel, 1996", "NSA, 1993", "NIST, 2001", "Keccak F1600 with XOF d=0x06 (FIPS 202); Bertoni, Daemen, Peeters, Van Assche, 2015", "fixed keylength of 16 bytes; Aumasson, Bernstein, 2012", "fixed keylength of 16 bytes; Aumasson, Bernstein, 2012", "Xiaoyun Wang et al., 2011", "Anderson, Biham, 1995", "Version 3.0; Rijmen, Barreto, 2000" };
+    static const char*  hash[] = { "adler32", "blake2b", "blake2s", "cmac_aes", "crc32", "crc32c", "keccak", "md2", "md4", "md5", "parallelhash128", "parallelhash256", "ripemd", "sha1", "sha2", "sha3", "siphash24", "siphash48", "sm3", "tiger", "whirlpool", "xxh3" };
+    static const char*  hash_label[] = { "Adler-32", "BLAKE2b", "BLAKE2s", "CMAC<AES>", "CRC-32", "CRC-32C", "Keccak", "MD2", "MD4", "MD5", "ParallelHash128", "ParallelHash256", "RIPEMD", "SHA-1", "SHA-2", "SHA-3", "SipHash-2-4", "SipHash-4-8", "SM3", "Tiger", "Whirlpool", "XXH3" };
+    static const char*  hash_info_url[] = { "Adler-32","BLAKE_(hash_function)#BLAKE2", "BLAKE_(hash_function)#BLAKE2", "One-key_MAC", "Cyclic_redundancy_check", "Cyclic_redundancy_check", "SHA-3", "MD2_(cryptography)", "MD4", "MD5", "SHA-3#Instances", "SHA-3#Instances", "RIPEMD", "SHA-1", "SHA-2", "SHA-3", "SipHash", "SipHash", "SM3", "Tiger_(cryptography)", "Whirlpool_(cryptography)", "List_of_hash_functions#Non-cryptographic_hash_functions" };
+    static const char*  hash_info[] = { "non-cryptographic checksum; Mark Adler, 1995", "Aumasson, Neves, O'Hearn, Winnerlein, 2012", "Aumasson, Neves, O'Hearn, Winnerlein, 2012", "fixed keylength of 16 bytes", "non-cryptographic checksum, polynomial: 0xEDB88320; Peterson, 1961", "non-cryptographic checksum, Castagnoli polynomial: 0x82F63B78 (iSCSI); Castagnoli, 1993", "f1600 with XOF d=0x01 (see SHA-3); Bertoni, Daemen, Peeters, Van Assche, 2015", "Ronald Rivest, 1989", "Ronald Rivest, 1990", "Ronald Rivest, 1992", "cSHAKE128 over 8192 byte blocks, optional customization string (SP 800-185); NIST, 2016", "cSHAKE256 over 8192 byte blocks, optional customization string (SP 800-185); NIST, 2016", "Dobbertin, Bosselaers, Preneel, 1996", "NSA, 1993", "NIST, 2001", "Keccak F1600 with XOF d=0x06 (FIPS 202); Bertoni, Daemen, Peeters, Van Assche, 2015", "fixed keylength of 16 bytes; Aumasson, Bernstein, 2012", "fixed keylength of 16 bytes; Aumasson, Bernstein, 2012", "Xiaoyun Wang et al., 2011", "Anderson, Biham, 1995", "Version 3.0; Rijmen, Barreto, 2000", "non-cryptographic 64/128 bit hash (xxHash 0.8); Yann Collet, 2019" };
 
-    static const char*  encoding[] = { "ascii", "base16", "base32", "base64" };
-    static const char*  encoding_info[] = { "notepad++ is not built for binary data", "standard hex-encoding", "DUDE base32 encoding", "RFC-4648 compatible base64 encoding" };
-    static const char*  encoding_info_url[] = { "ASCII", "Hexadecimal", "Base32", "Base64" };
+    static const char*  encoding[] = { "ascii", "base16", "base32", "base64", "base85" };
+    static const char*  encoding_info[] = { "notepad++ is not built for binary data", "standard hex-encoding", "DUDE base32 encoding", "RFC-4648 compatible base64 encoding", "Z85 base85 encoding: 4 bytes to 5 characters" };
+    static const char*  encoding_info_url[] = { "ASCII", "Hexadecimal", "Base32", "Base64", "Ascii85" };
 
     static const char*  key_algo[] = { "pbkdf2", "bcrypt", "scrypt" };
     static const char*  key_algo_info[] = { "HMAC is used as pseudo-random function", "compulsory 16 byte salt, SHA-3 shake128 will be used to get required key-length from fixed 23 byte output", "N - CPU/memory cost, r - blocksize, p - parallelization" };
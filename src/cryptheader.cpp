@@ -300,15 +300,37 @@ bool CryptHeaderReader::checkHMAC()
 
 void CryptHeaderWriter::create(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata, const nppcrypt::byte* data, size_t data_length)
 {
-    std::ostringstream      out;
-    size_t                  body_start;
-    size_t                  body_end;
-    size_t                  hmac_offset;
-    nppcrypt::secure_string    temp_s;
-
     if (!data || !data_length) {
         throwError(header_write_failed);
     }
+    size_t hmac_offset = write(options, initdata);
+    if (hmac_offset > 0) {
+        std::basic_string<nppcrypt::byte> buf;
+        nppcrypt::hash(hmac.hash, buf, { { body.start, body.length }, { data, data_length } });
+        setHMAC(hmac_offset, buf);
+    }
+}
+
+void CryptHeaderWriter::create(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata, const nppcrypt::SegmentedBuffer& data)
+{
+    if (!data.size()) {
+        throwError(header_write_failed);
+    }
+    size_t hmac_offset = write(options, initdata);
+    if (hmac_offset > 0) {
+        std::basic_string<nppcrypt::byte> buf;
+        nppcrypt::hash(hmac.hash, buf, body.start, body.length, data);
+        setHMAC(hmac_offset, buf);
+    }
+}
+
+size_t CryptHeaderWriter::write(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata)
+{
+    std::ostringstream      out;
+    size_t                  body_start;
+    size_t                  body_end;
+    size_t                  hmac_offset = 0;
+    std::string             temp_s;
 
     static const char win[] = { '\r', '\n', 0 };
     const char* linebreak;
@@ -394,14 +416,16 @@ void CryptHeaderWriter::create(const nppcrypt::Options::Crypt& options, const np
     body.start = (const nppcrypt::byte*)&buffer[body_start];
     body.length = body_end - body_start;
 
-    if (hmac.enable && hmac_offset > 0) {
-        // create hmac hash and insert it into header
-        std::basic_string<nppcrypt::byte> buf;
+    if (hmac.enable) {
         hmac.hash.encoding = nppcrypt::Encoding::base64;
-        nppcrypt::hash(hmac.hash, buf, { { body.start, body.length }, { data, data_length } });
-        std::string tstring(buf.begin(), buf.end());
-        buffer.replace(hmac_offset, tstring.size(), tstring);
     }
+    return hmac_offset;
+}
+
+void CryptHeaderWriter::setHMAC(size_t offset, const std::basic_string<nppcrypt::byte>& digest)
+{
+    std::string tstring(digest.begin(), digest.end());
+    buffer.replace(offset, tstring.size(), tstring);
 }
 
 size_t CryptHeaderWriter::base64length(size_t bin_length, bool linebreaks, size_t line_length, bool windows)
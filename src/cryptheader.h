@@ -67,10 +67,14 @@ class CryptHeaderWriter : public CryptHeader
 public:
                 CryptHeaderWriter(HMAC& hmac) : CryptHeader(hmac) {};
     void        create(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata, const nppcrypt::byte* data, size_t data_length);
+    void        create(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata, const nppcrypt::SegmentedBuffer& data);
     const char* c_str() { return buffer.c_str(); };
     size_t      size() { return buffer.size(); };
 
 private:
+    /* the header without hmac, returns the offset of the hmac placeholder (0: no hmac) */
+    size_t      write(const nppcrypt::Options::Crypt& options, const nppcrypt::InitData& initdata);
+    void        setHMAC(size_t offset, const std::basic_string<nppcrypt::byte>& digest);
     size_t      base64length(size_t bin_length, bool linebreaks=false, size_t line_length=0, bool windows=false);
 
     std::string buffer;
@@ -131,12 +131,123 @@ public:
 
 // ********************************************************
 
+// Nodes of the automatic sizes (256 bytes doubling up to s_maxAutoNodeSize) are
+// kept on a small per thread free list instead of being freed, so a queue that
+// grows and drains again (short messages, streaming) reuses them without new
+// and delete. A released node is wiped first, as SecByteBlock does when freed.
+#if defined(CRYPTOPP_CXX11)
+// Queues destroyed after the pool of their thread (static objects) free their nodes
+static thread_local bool s_nodePoolDestroyed = false;
+
+class ByteQueueNodePool
+{
+public:
+	ByteQueueNodePool()
+	{
+		for (unsigned int i=0; i<BUCKETS; i++)
+		{
+			m_free[i] = NULLPTR;
+			m_count[i] = 0;
+		}
+	}
+
+	~ByteQueueNodePool()
+	{
+		for (unsigned int i=0; i<BUCKETS; i++)
+		{
+			for (ByteQueueNode *next, *current=m_free[i]; current; current=next)
+			{
+				next=current->m_next;
+				delete current;
+			}
+		}
+		s_nodePoolDestroyed = true;
+	}
+
+	ByteQueueNode * Take(size_t size)
+	{
+		const unsigned int i = Bucket(size);
+		if (i == BUCKETS || !m_free[i])
+			return NULLPTR;
+
+		ByteQueueNode *node = m_free[i];
+		m_free[i] = node->m_next;
+		m_count[i]--;
+		node->m_next = NULLPTR;
+		return node;
+	}
+
+	bool Give(ByteQueueNode *node)
+	{
+		const unsigned int i = Bucket(node->MaxSize());
+		if (i == BUCKETS || m_count[i] == DEPTH)
+			return false;
+
+		SecureWipeBuffer(node->m_buf.begin(), node->m_buf.size());
+		node->Clear();
+		node->m_next = m_free[i];
+		m_free[i] = node;
+		m_count[i]++;
+		return true;
+	}
+
+private:
+	// 256, 512, ..., s_maxAutoNodeSize
+	enum {BUCKETS = 7, DEPTH = 4};
+
+	static unsigned int Bucket(size_t size)
+	{
+		unsigned int i = 0;
+		for (size_t s = 256; s <= s_maxAutoNodeSize; s *= 2, i++)
+		{
+			if (s == size)
+				return i;
+		}
+		return BUCKETS;
+	}
+
+	ByteQueueNode *m_free[BUCKETS];
+	unsigned int m_count[BUCKETS];
+};
+
+static ByteQueueNodePool * NodePool()
+{
+	if (s_nodePoolDestroyed)
+		return NULLPTR;
+	static thread_local ByteQueueNodePool pool;
+	return &pool;
+}
+#endif
+
+static ByteQueueNode * NewNode(size_t size)
+{
+#if defined(CRYPTOPP_CXX11)
+	ByteQueueNodePool *pool = NodePool();
+	ByteQueueNode *node = pool ? pool->Take(size) : NULLPTR;
+	if (node)
+		return node;
+#endif
+	return new ByteQueueNode(size);
+}
+
+static void DeleteNode(ByteQueueNode *node)
+{
+#if defined(CRYPTOPP_CXX11)
+	ByteQueueNodePool *pool = NodePool();
+	if (pool && pool->Give(node))
+		return;
+#endif
+	delete node;
+}
+
+// ********************************************************
+
 ByteQueue::ByteQueue(size_t nodeSize)
 	: Bufferless<BufferedTransformation>(), m_autoNodeSize(!nodeSize), m_nodeSize(nodeSize)
 	, m_head(NULLPTR), m_tail(NULLPTR), m_lazyString(NULLPTR), m_lazyLength(0), m_lazyStringModifiable(false)
 {
 	SetNodeSize(nodeSize);
-	m_head = m_tail = new ByteQueueNode(m_nodeSize);
+	m_head = m_tail = NewNode(m_nodeSize);
 }
 
 void ByteQueue::SetNodeSize(size_t nodeSize)
@@ -179,7 +290,7 @@ void ByteQueue::Destroy()
 	for (ByteQueueNode *next, *current=m_head; current; current=next)
 	{
 		next=current->m_next;
-		delete current;
+		DeleteNode(current);
 	}
 }
 
@@ -209,7 +320,7 @@ void ByteQueue::Clear()
 	for (ByteQueueNode *next, *current=m_head->m_next; current; current=next)
 	{
 		next=current->m_next;
-		delete current;
+		DeleteNode(current);
 	}
 
 	m_tail = m_head;
@@ -236,7 +347,7 @@ size_t ByteQueue::Put2(const byte *inString, size_t length, int messageEnd, bool
 				m_nodeSize *= 2;
 			}
 			while (m_nodeSize < length && m_nodeSize < s_maxAutoNodeSize);
-		m_tail->m_next = new ByteQueueNode(STDMAX(m_nodeSize, length));
+		m_tail->m_next = NewNode(STDMAX(m_nodeSize, length));
 		m_tail = m_tail->m_next;
 	}
 
@@ -250,7 +361,7 @@ void ByteQueue::CleanupUsedNodes()
 	{
 		ByteQueueNode *temp=m_head;
 		m_head=m_head->m_next;
-		delete temp;
+		DeleteNode(temp);
 	}
 
 	// Test for m_head due to Enterprise Anlysis finding
@@ -397,7 +508,7 @@ void ByteQueue::Unget(const byte *inString, size_t length)
 
 	if (length > 0)
 	{
-		ByteQueueNode *newHead = new ByteQueueNode(length);
+		ByteQueueNode *newHead = NewNode(length);
 		newHead->m_next = m_head;
 		m_head = newHead;
 		m_head->Put(inString, length);
@@ -423,7 +534,7 @@ byte * ByteQueue::CreatePutSpace(size_t &size)
 
 	if (m_tail->m_tail == m_tail->MaxSize())
 	{
-		m_tail->m_next = new ByteQueueNode(STDMAX(m_nodeSize, size));
+		m_tail->m_next = NewNode(STDMAX(m_nodeSize, size));
 		m_tail = m_tail->m_next;
 	}
 
@@ -65,7 +65,8 @@ const char* ExcInvalid::messages[] = {
     "invalid action parameter.",
     "cannot convert to same encoding.",
     "invalid eol.",
-    "failed to parse case."
+    "failed to parse case.",
+    "invalid alphabet (32, 64 or 85 unique characters, or z85|rfc1924).",
     "no header found.",
     "missing key-length.",
     "missing cipher-mode.",
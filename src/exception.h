@@ -81,6 +81,7 @@ public:
         invalid_convert_target_enc,
         invalid_eol,
         invalid_uppercase,
+        invalid_alphabet,
         missing_header,
         missing_keylength,
         missing_cipher_mode,
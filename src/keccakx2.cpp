@@ -0,0 +1,209 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <cstring>
+#include "keccakx2.h"
+#include "cryptopp/misc.h"
+#include "cryptopp/cpu.h"
+
+NAMESPACE_BEGIN(CryptoPP)
+/* keccak_core.cpp */
+extern void KeccakF1600(word64 *state);
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+/* keccak_simd.cpp */
+extern void KeccakF1600x2_SSE(word64 *state);
+#endif
+NAMESPACE_END
+
+using namespace nppcrypt;
+using CryptoPP::word64;
+
+namespace
+{
+    inline word64 load64(const byte* p)
+    {
+        return CryptoPP::GetWord<word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, p);
+    }
+
+    /* lanes of a state are step words apart: 1 for single states, 2 for interleaved KeccakF1600x2 states */
+    inline void xorBlock(word64* state, size_t step, const byte* in, size_t lanes)
+    {
+        for (size_t i = 0; i < lanes; i++) {
+            state[step * i] ^= load64(in + 8 * i);
+        }
+    }
+
+    /* padding: last holds at least rate bytes */
+    inline const byte* padBlock(byte* last, const byte* in, size_t length, size_t rate, byte suffix)
+    {
+        std::memset(last, 0, rate);
+        std::memcpy(last, in, length);
+        last[length] ^= suffix;
+        last[rate - 1] ^= 0x80;
+        return last;
+    }
+
+    inline void squeeze(const word64* state, size_t step, byte* out, size_t out_len)
+    {
+        byte temp[8];
+        size_t i = 0;
+        for (; 8 * i + 8 <= out_len; i++) {
+            CryptoPP::PutWord<word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, out + 8 * i, state[step * i]);
+        }
+        if (out_len % 8) {
+            CryptoPP::PutWord<word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, temp, state[step * i]);
+            std::memcpy(out + 8 * i, temp, out_len % 8);
+        }
+    }
+
+    inline bool useX2()
+    {
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+        return CryptoPP::HasSSSE3();
+#else
+        return false;
+#endif
+    }
+}
+
+void nppcrypt::keccak::sponge(const byte* in, size_t length, size_t rate, byte suffix, byte* out, size_t out_len)
+{
+    word64 state[25] = { 0 };
+    byte last[168];
+    const size_t lanes = rate / 8;
+
+    for (; length >= rate; length -= rate, in += rate) {
+        xorBlock(state, 1, in, lanes);
+        CryptoPP::KeccakF1600(state);
+    }
+    xorBlock(state, 1, padBlock(last, in, length, rate, suffix), lanes);
+    CryptoPP::KeccakF1600(state);
+    squeeze(state, 1, out, out_len);
+
+    CryptoPP::SecureWipeArray(state, 25);
+    CryptoPP::SecureWipeArray(last, sizeof(last));
+}
+
+void nppcrypt::keccak::sponge(const byte* in0, const byte* in1, size_t length, size_t rate, byte suffix, byte* out0, byte* out1, size_t out_len)
+{
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+    if (useX2()) {
+        CRYPTOPP_ALIGN_DATA(16) word64 state[50] = { 0 };
+        byte last[168];
+        const size_t lanes = rate / 8;
+
+        for (; length >= rate; length -= rate, in0 += rate, in1 += rate) {
+            xorBlock(state, 2, in0, lanes);
+            xorBlock(state + 1, 2, in1, lanes);
+            CryptoPP::KeccakF1600x2_SSE(state);
+        }
+        xorBlock(state, 2, padBlock(last, in0, length, rate, suffix), lanes);
+        xorBlock(state + 1, 2, padBlock(last, in1, length, rate, suffix), lanes);
+        CryptoPP::KeccakF1600x2_SSE(state);
+        squeeze(state, 2, out0, out_len);
+        squeeze(state + 1, 2, out1, out_len);
+
+        CryptoPP::SecureWipeArray(state, 50);
+        CryptoPP::SecureWipeArray(last, sizeof(last));
+        return;
+    }
+#endif
+    sponge(in0, length, rate, suffix, out0, out_len);
+    sponge(in1, length, rate, suffix, out1, out_len);
+}
+
+void nppcrypt::keccak::sponge(const byte* in, size_t count, size_t length, size_t rate, byte suffix, byte* out, size_t out_len)
+{
+    if (useX2()) {
+        for (; count >= 2; count -= 2) {
+            sponge(in, in + length, length, rate, suffix, out, out + out_len, out_len);
+            in += 2 * length;
+            out += 2 * out_len;
+        }
+    }
+    for (; count; count--) {
+        sponge(in, length, rate, suffix, out, out_len);
+        in += length;
+        out += out_len;
+    }
+}
+
+void nppcrypt::keccak::batch(const std::pair<const byte*, size_t>* in, size_t count, size_t rate, byte suffix, byte* out, size_t out_len)
+{
+    size_t next = 0;
+#if (CRYPTOPP_SSSE3_AVAILABLE)
+    if (useX2() && count >= 2) {
+        /* every lane takes the next input as soon as its current one is finished, so inputs of
+           different length keep both halves of the state busy */
+        struct Lane {
+            const byte* data;
+            size_t      left;
+            byte*       out;
+            bool        active;
+        } lane[2];
+        CRYPTOPP_ALIGN_DATA(16) word64 state[50];
+        byte last[168];
+        const size_t lanes = rate / 8;
+
+        for (int l = 0; l < 2; l++) {
+            lane[l].data = in[next].first;
+            lane[l].left = in[next].second;
+            lane[l].out = out + next * out_len;
+            lane[l].active = true;
+            next++;
+        }
+        std::memset(state, 0, sizeof(state));
+        while (lane[0].active || lane[1].active) {
+            bool final[2] = { false, false };
+            for (int l = 0; l < 2; l++) {
+                if (!lane[l].active) {
+                    continue;
+                }
+                if (lane[l].left >= rate) {
+                    xorBlock(state + l, 2, lane[l].data, lanes);
+                    lane[l].data += rate;
+                    lane[l].left -= rate;
+                } else {
+                    xorBlock(state + l, 2, padBlock(last, lane[l].data, lane[l].left, rate, suffix), lanes);
+                    final[l] = true;
+                }
+            }
+            CryptoPP::KeccakF1600x2_SSE(state);
+            for (int l = 0; l < 2; l++) {
+                if (!final[l]) {
+                    continue;
+                }
+                squeeze(state + l, 2, lane[l].out, out_len);
+                for (size_t i = 0; i < 25; i++) {
+                    state[2 * i + l] = 0;
+                }
+                if (next < count) {
+                    lane[l].data = in[next].first;
+                    lane[l].left = in[next].second;
+                    lane[l].out = out + next * out_len;
+                    next++;
+                } else {
+                    lane[l].active = false;
+                }
+            }
+        }
+        CryptoPP::SecureWipeArray(state, 50);
+        CryptoPP::SecureWipeArray(last, sizeof(last));
+    }
+#endif
+    for (; next < count; next++) {
+        sponge(in[next].first, in[next].second, rate, suffix, out + next * out_len, out_len);
+    }
+}
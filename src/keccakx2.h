@@ -0,0 +1,39 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef KECCAKX2_H_DEF
+#define KECCAKX2_H_DEF
+
+#include <utility>
+#include "crypt.h"
+
+/* Keccak-f[1600] sponges for short independent inputs: if SSSE3 is available two states are processed at once
+   with cryptopp's KeccakF1600x2_SSE, otherwise the scalar KeccakF1600 is used.
+   rate in bytes (max. 168), suffix: 0x01 keccak, 0x06 sha3, 0x1F shake; out_len <= rate */
+namespace nppcrypt
+{
+    namespace keccak
+    {
+        void sponge(const byte* in, size_t length, size_t rate, byte suffix, byte* out, size_t out_len);
+        /* two inputs of equal length */
+        void sponge(const byte* in0, const byte* in1, size_t length, size_t rate, byte suffix, byte* out0, byte* out1, size_t out_len);
+        /* count inputs of equal length, digests are written consecutively to out */
+        void sponge(const byte* in, size_t count, size_t length, size_t rate, byte suffix, byte* out, size_t out_len);
+        /* count inputs of any length, digests are written consecutively to out */
+        void batch(const std::pair<const byte*, size_t>* in, size_t count, size_t rate, byte suffix, byte* out, size_t out_len);
+    };
+};
+
+#endif
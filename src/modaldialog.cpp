@@ -117,6 +117,7 @@ void ModalDialog::setupInputEncodingSelect(HWND hwnd, int id)
     ::SendDlgItemMessage(hwnd, id, CB_ADDSTRING, 0, (LPARAM)TEXT("base16"));
     ::SendDlgItemMessage(hwnd, id, CB_ADDSTRING, 0, (LPARAM)TEXT("base32"));
     ::SendDlgItemMessage(hwnd, id, CB_ADDSTRING, 0, (LPARAM)TEXT("base64"));
+    ::SendDlgItemMessage(hwnd, id, CB_ADDSTRING, 0, (LPARAM)TEXT("base85"));
     ::SendDlgItemMessage(hwnd, id, CB_SETCURSEL, 0, 0);
 }
 
@@ -0,0 +1,255 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <cstring>
+#include <vector>
+#include "multibuffer.h"
+#include "cryptopp/misc.h"
+#include "cryptopp/cpu.h"
+
+using namespace nppcrypt;
+using namespace nppcrypt::multibuffer;
+using CryptoPP::word32;
+
+namespace
+{
+    const word32 md5_iv[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+    const word32 sha1_iv[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+    const word32 sha256_iv[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+
+    /* bytes read from a Source per lane and refill */
+    const size_t chunk_size = 65536;
+
+    struct Lane
+    {
+        bool                active;
+        size_t              index;
+        const byte*         data;
+        size_t              blocks;
+        const byte*         rest;
+        size_t              rest_length;
+        unsigned long long  total;
+        bool                eof;
+        bool                tail;
+        byte                pad[128];
+        std::vector<byte>   chunk;
+    };
+
+    class Scheduler
+    {
+    public:
+        Scheduler(Algorithm a, const std::pair<const byte*, size_t>* in, Source* src, size_t count, byte* out)
+            : algorithm(a), memory(in), source(src), count(count), next(0), out(out)
+        {
+            switch (a) {
+            case Algorithm::md5: iv = md5_iv; words = 4; break;
+            case Algorithm::sha1: iv = sha1_iv; words = 5; break;
+            default: iv = sha256_iv; words = 8; break;
+            }
+        }
+
+        ~Scheduler()
+        {
+            CryptoPP::SecureWipeArray(state, sizeof(state) / sizeof(word32));
+            for (unsigned int l = 0; l < lanes; l++) {
+                CryptoPP::SecureWipeArray(lane[l].pad, sizeof(lane[l].pad));
+            }
+        }
+
+        void run()
+        {
+            for (unsigned int l = 0; l < lanes; l++) {
+                lane[l].active = false;
+                if (source) {
+                    lane[l].chunk.resize(chunk_size);
+                }
+                assign(l);
+            }
+            for (;;) {
+                size_t n = 0;
+                int first = -1;
+                for (unsigned int l = 0; l < lanes; l++) {
+                    if (!prepare(l)) {
+                        continue;
+                    }
+                    if (first < 0 || lane[l].blocks < n) {
+                        n = lane[l].blocks;
+                    }
+                    if (first < 0) {
+                        first = (int)l;
+                    }
+                }
+                if (first < 0) {
+                    break;
+                }
+                /* idle lanes hash the data of an active lane, their result is ignored */
+                const byte* data[lanes];
+                for (unsigned int l = 0; l < lanes; l++) {
+                    data[l] = lane[l].active ? lane[l].data : lane[first].data;
+                }
+                compress(data, n);
+                for (unsigned int l = 0; l < lanes; l++) {
+                    if (lane[l].active) {
+                        lane[l].data = data[l];
+                        lane[l].blocks -= n;
+                    }
+                }
+            }
+        }
+
+    private:
+        void compress(const byte** data, size_t blocks)
+        {
+#if (CRYPTOPP_AVX2_AVAILABLE)
+            switch (algorithm) {
+            case Algorithm::md5: simd::md5_x8(state, data, blocks); break;
+            case Algorithm::sha1: simd::sha1_x8(state, data, blocks); break;
+            case Algorithm::sha256: simd::sha256_x8(state, data, blocks); break;
+            }
+#endif
+        }
+
+        /* lane takes the next input, returns false if there is none */
+        bool assign(unsigned int l)
+        {
+            Lane& ln = lane[l];
+            if (next >= count) {
+                ln.active = false;
+                return false;
+            }
+            ln.active = true;
+            ln.index = next++;
+            ln.tail = false;
+            ln.total = 0;
+            ln.blocks = 0;
+            if (source) {
+                source->open(ln.index, l);
+                ln.eof = false;
+            } else {
+                const std::pair<const byte*, size_t>& m = memory[ln.index];
+                ln.data = m.first;
+                ln.blocks = m.second / 64;
+                ln.rest = m.first + ln.blocks * 64;
+                ln.rest_length = m.second % 64;
+                ln.total = m.second;
+                ln.eof = true;
+            }
+            for (unsigned int w = 0; w < words; w++) {
+                state[w * lanes + l] = iv[w];
+            }
+            return true;
+        }
+
+        /* makes sure an active lane has at least one block, returns false if the lane is idle */
+        bool prepare(unsigned int l)
+        {
+            Lane& ln = lane[l];
+            while (ln.active && !ln.blocks) {
+                if (!ln.eof) {
+                    size_t fill = 0;
+                    while (fill < chunk_size) {
+                        size_t r = source->read(l, &ln.chunk[fill], chunk_size - fill);
+                        if (!r) {
+                            ln.eof = true;
+                            break;
+                        }
+                        fill += r;
+                    }
+                    ln.data = &ln.chunk[0];
+                    ln.blocks = fill / 64;
+                    ln.rest = &ln.chunk[0] + ln.blocks * 64;
+                    ln.rest_length = fill % 64;
+                    ln.total += fill;
+                } else if (!ln.tail) {
+                    padding(ln);
+                } else {
+                    finish(l);
+                    assign(l);
+                }
+            }
+            return ln.active;
+        }
+
+        void padding(Lane& ln)
+        {
+            unsigned long long bits = ln.total * 8;
+            size_t length = (ln.rest_length + 9 <= 64) ? 64 : 128;
+            std::memset(ln.pad, 0, length);
+            std::memcpy(ln.pad, ln.rest, ln.rest_length);
+            ln.pad[ln.rest_length] = 0x80;
+            for (int i = 0; i < 8; i++) {
+                byte b = (byte)(bits >> (8 * i));
+                if (algorithm == Algorithm::md5) {
+                    ln.pad[length - 8 + i] = b;
+                } else {
+                    ln.pad[length - 1 - i] = b;
+                }
+            }
+            ln.data = ln.pad;
+            ln.blocks = length / 64;
+            ln.tail = true;
+        }
+
+        void finish(unsigned int l)
+        {
+            byte* digest = out + lane[l].index * words * 4;
+            CryptoPP::ByteOrder order = (algorithm == Algorithm::md5) ? CryptoPP::LITTLE_ENDIAN_ORDER : CryptoPP::BIG_ENDIAN_ORDER;
+            for (unsigned int w = 0; w < words; w++) {
+                CryptoPP::PutWord<word32>(false, order, digest + 4 * w, state[w * lanes + l]);
+            }
+        }
+
+        Algorithm                               algorithm;
+        const std::pair<const byte*, size_t>*   memory;
+        Source*                                 source;
+        size_t                                  count;
+        size_t                                  next;
+        byte*                                   out;
+        const word32*                           iv;
+        unsigned int                            words;
+        Lane                                    lane[lanes];
+        CRYPTOPP_ALIGN_DATA(32) word32          state[8 * lanes];
+    };
+}
+
+bool nppcrypt::multibuffer::accelerated()
+{
+#if (CRYPTOPP_AVX2_AVAILABLE)
+    return CryptoPP::HasAVX2();
+#else
+    return false;
+#endif
+}
+
+size_t nppcrypt::multibuffer::digestSize(Algorithm a)
+{
+    switch (a) {
+    case Algorithm::md5: return 16;
+    case Algorithm::sha1: return 20;
+    default: return 32;
+    }
+}
+
+void nppcrypt::multibuffer::hash(Algorithm a, const std::pair<const byte*, size_t>* in, size_t count, byte* out)
+{
+    Scheduler s(a, in, NULL, count, out);
+    s.run();
+}
+
+void nppcrypt::multibuffer::hash(Algorithm a, Source& in, size_t count, byte* out)
+{
+    Scheduler s(a, NULL, &in, count, out);
+    s.run();
+}
@@ -0,0 +1,62 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef MULTIBUFFER_H_DEF
+#define MULTIBUFFER_H_DEF
+
+#include <utility>
+#include "crypt.h"
+
+/* multi-buffer MD5/SHA-1/SHA-256: eight independent messages are hashed at once, one per 32 bit lane of the
+   AVX2 registers. Every lane takes the next message as soon as its current one is finished.
+   Only available if accelerated() is true, callers fall back to cryptopp otherwise. */
+namespace nppcrypt
+{
+    namespace multibuffer
+    {
+        enum class Algorithm : unsigned {
+            md5, sha1, sha256
+        };
+
+        /* inputs that are read in chunks (i.e. files): open() is called when a lane takes input index,
+           read() is called until it returns 0 */
+        class Source
+        {
+        public:
+            virtual ~Source() {};
+            virtual void    open(size_t index, unsigned int lane) = 0;
+            virtual size_t  read(unsigned int lane, byte* out, size_t length) = 0;
+        };
+
+        const unsigned int  lanes = 8;
+
+        bool    accelerated();
+        size_t  digestSize(Algorithm a);
+        /* digests of count inputs, written consecutively to out */
+        void    hash(Algorithm a, const std::pair<const byte*, size_t>* in, size_t count, byte* out);
+        void    hash(Algorithm a, Source& in, size_t count, byte* out);
+
+        namespace simd
+        {
+            /* one or more 64 byte blocks per lane: state is transposed (word w of lane l: state[w * lanes + l]),
+               data[l] is advanced by 64 * blocks */
+            void md5_x8(CryptoPP::word32* state, const byte** data, size_t blocks);
+            void sha1_x8(CryptoPP::word32* state, const byte** data, size_t blocks);
+            void sha256_x8(CryptoPP::word32* state, const byte** data, size_t blocks);
+        };
+    };
+};
+
+#endif
@@ -0,0 +1,343 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* AVX2 multi-buffer compression functions, needs -mavx2 with gcc/clang (see GNUmakefile) */
+
+#include "multibuffer.h"
+#include "cryptopp/config.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <immintrin.h>
+#endif
+
+using CryptoPP::word32;
+
+namespace nppcrypt
+{
+namespace multibuffer
+{
+namespace simd
+{
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+namespace
+{
+    template <int N> inline __m256i rotl(__m256i x)
+    {
+        return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+    }
+
+    template <int N> inline __m256i rotr(__m256i x)
+    {
+        return _mm256_or_si256(_mm256_srli_epi32(x, N), _mm256_slli_epi32(x, 32 - N));
+    }
+
+    inline __m256i add(__m256i a, __m256i b)
+    {
+        return _mm256_add_epi32(a, b);
+    }
+
+    inline __m256i add(__m256i a, __m256i b, __m256i c)
+    {
+        return _mm256_add_epi32(_mm256_add_epi32(a, b), c);
+    }
+
+    inline __m256i constant(word32 k)
+    {
+        return _mm256_set1_epi32((int)k);
+    }
+
+    /* w[i] = word i of the current block of every lane (32 bytes of 8 lanes transposed), bswap: big endian words */
+    inline void transpose(__m256i* w, const byte* const* data, size_t offset, bool bswap)
+    {
+        const __m256i mask = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                              3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        __m256i r[8], t[8], u[8];
+        for (int l = 0; l < 8; l++) {
+            r[l] = _mm256_loadu_si256((const __m256i*)(data[l] + offset));
+            if (bswap) {
+                r[l] = _mm256_shuffle_epi8(r[l], mask);
+            }
+        }
+        for (int i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_epi32(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_epi32(r[i], r[i + 1]);
+        }
+        for (int i = 0; i < 8; i += 4) {
+            u[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+            u[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+            u[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+            u[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+        }
+        for (int i = 0; i < 4; i++) {
+            w[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+            w[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+        }
+    }
+
+    inline void loadBlock(__m256i* w, const byte** data, bool bswap)
+    {
+        transpose(w, data, 0, bswap);
+        transpose(w + 8, data, 32, bswap);
+        for (int l = 0; l < 8; l++) {
+            data[l] += 64;
+        }
+    }
+
+    inline __m256i md5_f(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)));
+    }
+
+    inline __m256i md5_g(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(y, _mm256_and_si256(z, _mm256_xor_si256(x, y)));
+    }
+
+    inline __m256i md5_h(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+    }
+
+    inline __m256i md5_i(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(y, _mm256_or_si256(x, _mm256_xor_si256(z, _mm256_set1_epi32(-1))));
+    }
+
+    inline __m256i sha_ch(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(z, _mm256_and_si256(x, _mm256_xor_si256(y, z)));
+    }
+
+    inline __m256i sha_maj(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_or_si256(_mm256_and_si256(x, y), _mm256_and_si256(z, _mm256_or_si256(x, y)));
+    }
+
+    inline __m256i sha_parity(__m256i x, __m256i y, __m256i z)
+    {
+        return _mm256_xor_si256(_mm256_xor_si256(x, y), z);
+    }
+
+    const word32 sha256_k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+}
+
+#define MD5_STEP(f, a, b, c, d, x, t, s) a = add(b, rotl<s>(add(a, f(b, c, d), add(x, constant(t)))))
+
+void md5_x8(word32* state, const byte** data, size_t blocks)
+{
+    __m256i a = _mm256_load_si256((const __m256i*)(state + 0));
+    __m256i b = _mm256_load_si256((const __m256i*)(state + 8));
+    __m256i c = _mm256_load_si256((const __m256i*)(state + 16));
+    __m256i d = _mm256_load_si256((const __m256i*)(state + 24));
+    __m256i x[16];
+
+    for (; blocks; blocks--) {
+        __m256i aa = a, bb = b, cc = c, dd = d;
+        loadBlock(x, data, false);
+
+        MD5_STEP(md5_f, a, b, c, d, x[0], 0xd76aa478, 7);
+        MD5_STEP(md5_f, d, a, b, c, x[1], 0xe8c7b756, 12);
+        MD5_STEP(md5_f, c, d, a, b, x[2], 0x242070db, 17);
+        MD5_STEP(md5_f, b, c, d, a, x[3], 0xc1bdceee, 22);
+        MD5_STEP(md5_f, a, b, c, d, x[4], 0xf57c0faf, 7);
+        MD5_STEP(md5_f, d, a, b, c, x[5], 0x4787c62a, 12);
+        MD5_STEP(md5_f, c, d, a, b, x[6], 0xa8304613, 17);
+        MD5_STEP(md5_f, b, c, d, a, x[7], 0xfd469501, 22);
+        MD5_STEP(md5_f, a, b, c, d, x[8], 0x698098d8, 7);
+        MD5_STEP(md5_f, d, a, b, c, x[9], 0x8b44f7af, 12);
+        MD5_STEP(md5_f, c, d, a, b, x[10], 0xffff5bb1, 17);
+        MD5_STEP(md5_f, b, c, d, a, x[11], 0x895cd7be, 22);
+        MD5_STEP(md5_f, a, b, c, d, x[12], 0x6b901122, 7);
+        MD5_STEP(md5_f, d, a, b, c, x[13], 0xfd987193, 12);
+        MD5_STEP(md5_f, c, d, a, b, x[14], 0xa679438e, 17);
+        MD5_STEP(md5_f, b, c, d, a, x[15], 0x49b40821, 22);
+
+        MD5_STEP(md5_g, a, b, c, d, x[1], 0xf61e2562, 5);
+        MD5_STEP(md5_g, d, a, b, c, x[6], 0xc040b340, 9);
+        MD5_STEP(md5_g, c, d, a, b, x[11], 0x265e5a51, 14);
+        MD5_STEP(md5_g, b, c, d, a, x[0], 0xe9b6c7aa, 20);
+        MD5_STEP(md5_g, a, b, c, d, x[5], 0xd62f105d, 5);
+        MD5_STEP(md5_g, d, a, b, c, x[10], 0x02441453, 9);
+        MD5_STEP(md5_g, c, d, a, b, x[15], 0xd8a1e681, 14);
+        MD5_STEP(md5_g, b, c, d, a, x[4], 0xe7d3fbc8, 20);
+        MD5_STEP(md5_g, a, b, c, d, x[9], 0x21e1cde6, 5);
+        MD5_STEP(md5_g, d, a, b, c, x[14], 0xc33707d6, 9);
+        MD5_STEP(md5_g, c, d, a, b, x[3], 0xf4d50d87, 14);
+        MD5_STEP(md5_g, b, c, d, a, x[8], 0x455a14ed, 20);
+        MD5_STEP(md5_g, a, b, c, d, x[13], 0xa9e3e905, 5);
+        MD5_STEP(md5_g, d, a, b, c, x[2], 0xfcefa3f8, 9);
+        MD5_STEP(md5_g, c, d, a, b, x[7], 0x676f02d9, 14);
+        MD5_STEP(md5_g, b, c, d, a, x[12], 0x8d2a4c8a, 20);
+
+        MD5_STEP(md5_h, a, b, c, d, x[5], 0xfffa3942, 4);
+        MD5_STEP(md5_h, d, a, b, c, x[8], 0x8771f681, 11);
+        MD5_STEP(md5_h, c, d, a, b, x[11], 0x6d9d6122, 16);
+        MD5_STEP(md5_h, b, c, d, a, x[14], 0xfde5380c, 23);
+        MD5_STEP(md5_h, a, b, c, d, x[1], 0xa4beea44, 4);
+        MD5_STEP(md5_h, d, a, b, c, x[4], 0x4bdecfa9, 11);
+        MD5_STEP(md5_h, c, d, a, b, x[7], 0xf6bb4b60, 16);
+        MD5_STEP(md5_h, b, c, d, a, x[10], 0xbebfbc70, 23);
+        MD5_STEP(md5_h, a, b, c, d, x[13], 0x289b7ec6, 4);
+        MD5_STEP(md5_h, d, a, b, c, x[0], 0xeaa127fa, 11);
+        MD5_STEP(md5_h, c, d, a, b, x[3], 0xd4ef3085, 16);
+        MD5_STEP(md5_h, b, c, d, a, x[6], 0x04881d05, 23);
+        MD5_STEP(md5_h, a, b, c, d, x[9], 0xd9d4d039, 4);
+        MD5_STEP(md5_h, d, a, b, c, x[12], 0xe6db99e5, 11);
+        MD5_STEP(md5_h, c, d, a, b, x[15], 0x1fa27cf8, 16);
+        MD5_STEP(md5_h, b, c, d, a, x[2], 0xc4ac5665, 23);
+
+        MD5_STEP(md5_i, a, b, c, d, x[0], 0xf4292244, 6);
+        MD5_STEP(md5_i, d, a, b, c, x[7], 0x432aff97, 10);
+        MD5_STEP(md5_i, c, d, a, b, x[14], 0xab9423a7, 15);
+        MD5_STEP(md5_i, b, c, d, a, x[5], 0xfc93a039, 21);
+        MD5_STEP(md5_i, a, b, c, d, x[12], 0x655b59c3, 6);
+        MD5_STEP(md5_i, d, a, b, c, x[3], 0x8f0ccc92, 10);
+        MD5_STEP(md5_i, c, d, a, b, x[10], 0xffeff47d, 15);
+        MD5_STEP(md5_i, b, c, d, a, x[1], 0x85845dd1, 21);
+        MD5_STEP(md5_i, a, b, c, d, x[8], 0x6fa87e4f, 6);
+        MD5_STEP(md5_i, d, a, b, c, x[15], 0xfe2ce6e0, 10);
+        MD5_STEP(md5_i, c, d, a, b, x[6], 0xa3014314, 15);
+        MD5_STEP(md5_i, b, c, d, a, x[13], 0x4e0811a1, 21);
+        MD5_STEP(md5_i, a, b, c, d, x[4], 0xf7537e82, 6);
+        MD5_STEP(md5_i, d, a, b, c, x[11], 0xbd3af235, 10);
+        MD5_STEP(md5_i, c, d, a, b, x[2], 0x2ad7d2bb, 15);
+        MD5_STEP(md5_i, b, c, d, a, x[9], 0xeb86d391, 21);
+
+        a = add(a, aa);
+        b = add(b, bb);
+        c = add(c, cc);
+        d = add(d, dd);
+    }
+    _mm256_store_si256((__m256i*)(state + 0), a);
+    _mm256_store_si256((__m256i*)(state + 8), b);
+    _mm256_store_si256((__m256i*)(state + 16), c);
+    _mm256_store_si256((__m256i*)(state + 24), d);
+    _mm256_zeroupper();
+}
+
+#undef MD5_STEP
+
+void sha1_x8(word32* state, const byte** data, size_t blocks)
+{
+    __m256i h[5];
+    __m256i w[16];
+    for (int i = 0; i < 5; i++) {
+        h[i] = _mm256_load_si256((const __m256i*)(state + 8 * i));
+    }
+
+    for (; blocks; blocks--) {
+        __m256i a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        loadBlock(w, data, true);
+
+        for (int i = 0; i < 80; i++) {
+            if (i >= 16) {
+                __m256i x = _mm256_xor_si256(_mm256_xor_si256(w[(i - 3) & 15], w[(i - 8) & 15]), _mm256_xor_si256(w[(i - 14) & 15], w[i & 15]));
+                w[i & 15] = rotl<1>(x);
+            }
+            __m256i f, k;
+            if (i < 20) {
+                f = sha_ch(b, c, d);
+                k = constant(0x5a827999);
+            } else if (i < 40) {
+                f = sha_parity(b, c, d);
+                k = constant(0x6ed9eba1);
+            } else if (i < 60) {
+                f = sha_maj(b, c, d);
+                k = constant(0x8f1bbcdc);
+            } else {
+                f = sha_parity(b, c, d);
+                k = constant(0xca62c1d6);
+            }
+            __m256i t = add(add(rotl<5>(a), f, e), k, w[i & 15]);
+            e = d;
+            d = c;
+            c = rotl<30>(b);
+            b = a;
+            a = t;
+        }
+        h[0] = add(h[0], a);
+        h[1] = add(h[1], b);
+        h[2] = add(h[2], c);
+        h[3] = add(h[3], d);
+        h[4] = add(h[4], e);
+    }
+    for (int i = 0; i < 5; i++) {
+        _mm256_store_si256((__m256i*)(state + 8 * i), h[i]);
+    }
+    _mm256_zeroupper();
+}
+
+void sha256_x8(word32* state, const byte** data, size_t blocks)
+{
+    __m256i h[8];
+    __m256i w[16];
+    for (int i = 0; i < 8; i++) {
+        h[i] = _mm256_load_si256((const __m256i*)(state + 8 * i));
+    }
+
+    for (; blocks; blocks--) {
+        __m256i a = h[0], b = h[1], c = h[2], d = h[3], e = h[4], f = h[5], g = h[6], hh = h[7];
+        loadBlock(w, data, true);
+
+        for (int i = 0; i < 64; i++) {
+            if (i >= 16) {
+                __m256i w15 = w[(i - 15) & 15];
+                __m256i w2 = w[(i - 2) & 15];
+                __m256i s0 = _mm256_xor_si256(_mm256_xor_si256(rotr<7>(w15), rotr<18>(w15)), _mm256_srli_epi32(w15, 3));
+                __m256i s1 = _mm256_xor_si256(_mm256_xor_si256(rotr<17>(w2), rotr<19>(w2)), _mm256_srli_epi32(w2, 10));
+                w[i & 15] = add(add(w[i & 15], s0), w[(i - 7) & 15], s1);
+            }
+            __m256i S1 = _mm256_xor_si256(_mm256_xor_si256(rotr<6>(e), rotr<11>(e)), rotr<25>(e));
+            __m256i t1 = add(add(hh, S1, sha_ch(e, f, g)), constant(sha256_k[i]), w[i & 15]);
+            __m256i S0 = _mm256_xor_si256(_mm256_xor_si256(rotr<2>(a), rotr<13>(a)), rotr<22>(a));
+            __m256i t2 = add(S0, sha_maj(a, b, c));
+            hh = g;
+            g = f;
+            f = e;
+            e = add(d, t1);
+            d = c;
+            c = b;
+            b = a;
+            a = add(t1, t2);
+        }
+        h[0] = add(h[0], a);
+        h[1] = add(h[1], b);
+        h[2] = add(h[2], c);
+        h[3] = add(h[3], d);
+        h[4] = add(h[4], e);
+        h[5] = add(h[5], f);
+        h[6] = add(h[6], g);
+        h[7] = add(h[7], hh);
+    }
+    for (int i = 0; i < 8; i++) {
+        _mm256_store_si256((__m256i*)(state + 8 * i), h[i]);
+    }
+    _mm256_zeroupper();
+}
+#endif
+
+};
+};
+};
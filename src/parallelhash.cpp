@@ -0,0 +1,208 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <thread>
+#include <cstring>
+#include <cstdint>
+#include "parallelhash.h"
+#include "keccakx2.h"
+
+using namespace nppcrypt;
+
+namespace
+{
+    const byte function_name[] = { 'P', 'a', 'r', 'a', 'l', 'l', 'e', 'l', 'H', 'a', 's', 'h' };
+
+    /* left_encode() / right_encode() of SP 800-185, returns number of bytes written to out (max. 9) */
+    size_t encode(unsigned long long x, byte* out, bool left)
+    {
+        byte temp[8];
+        size_t n = 0;
+        do {
+            temp[n++] = (byte)x;
+            x >>= 8;
+        } while (x && n < 8);
+        size_t k = 0;
+        if (left) {
+            out[k++] = (byte)n;
+        }
+        for (size_t i = n; i > 0; i--) {
+            out[k++] = temp[i - 1];
+        }
+        if (!left) {
+            out[k++] = (byte)n;
+        }
+        return k;
+    }
+
+    /* SHAKE128/256 of count blocks */
+    void hashBlocks(const byte* in, size_t count, size_t length, size_t rate, byte* out, size_t out_len)
+    {
+        keccak::sponge(in, count, length, rate, 0x1F, out, out_len);
+    }
+
+    size_t workerCount(size_t count)
+    {
+        size_t threads = std::thread::hardware_concurrency();
+        if (threads <= 1 || count < 2 * Constants::parallelhash_thread_min) {
+            return 1;
+        }
+        return std::min(threads, count / Constants::parallelhash_thread_min);
+    }
+}
+
+nppcrypt::ParallelHash::ParallelHash(unsigned int security, unsigned int digest, const byte* custom, size_t custom_len, size_t block)
+    : strength(security == 256 ? 256 : 128), digest_size(digest), blocksize(block ? block : Constants::parallelhash_blocksize), block_count(0), buffered(0)
+{
+    rate = (strength == 256) ? 136 : 168;
+    chain_size = strength / 4;
+    if (custom && custom_len) {
+        customization.assign(custom, custom + custom_len);
+    }
+    buffer.New(blocksize * Constants::parallelhash_batch);
+    Restart();
+}
+
+void* nppcrypt::ParallelHash::operator new(size_t size)
+{
+    /* the block returned by ::operator new is stored in front of the aligned object */
+    const size_t align = alignof(ParallelHash);
+    void* block = ::operator new(size + align + sizeof(void*));
+    uintptr_t p = ((uintptr_t)block + sizeof(void*) + align - 1) & ~(uintptr_t)(align - 1);
+    ((void**)p)[-1] = block;
+    return (void*)p;
+}
+
+void nppcrypt::ParallelHash::operator delete(void* p)
+{
+    if (p) {
+        ::operator delete(((void**)p)[-1]);
+    }
+}
+
+std::string nppcrypt::ParallelHash::AlgorithmName() const
+{
+    return (strength == 256) ? "ParallelHash256" : "ParallelHash128";
+}
+
+void nppcrypt::ParallelHash::Restart()
+{
+    byte enc[9];
+    size_t len;
+
+    /* cSHAKE: bytepad(encode_string(N) || encode_string(S), rate) */
+    Keccak_HashInitialize(&outer, (unsigned int)rate * 8, 1600 - (unsigned int)rate * 8, 0, 0x04);
+    len = encode(rate, enc, true);
+    size_t total = len;
+    Keccak_HashUpdate(&outer, enc, len * 8);
+    len = encode(sizeof(function_name) * 8, enc, true);
+    total += len + sizeof(function_name);
+    Keccak_HashUpdate(&outer, enc, len * 8);
+    Keccak_HashUpdate(&outer, function_name, sizeof(function_name) * 8);
+    len = encode((unsigned long long)customization.size() * 8, enc, true);
+    total += len + customization.size();
+    Keccak_HashUpdate(&outer, enc, len * 8);
+    if (customization.size()) {
+        Keccak_HashUpdate(&outer, &customization[0], customization.size() * 8);
+    }
+    if (total % rate) {
+        byte zeros[168] = { 0 };
+        Keccak_HashUpdate(&outer, zeros, (rate - total % rate) * 8);
+    }
+
+    /* ParallelHash: left_encode(B) */
+    len = encode(blocksize, enc, true);
+    Keccak_HashUpdate(&outer, enc, len * 8);
+
+    buffered = 0;
+    block_count = 0;
+}
+
+void nppcrypt::ParallelHash::absorbBlocks(const byte* input, size_t count, size_t length)
+{
+    if (chain.size() < count * chain_size) {
+        chain.New(count * chain_size);
+    }
+    size_t threads = workerCount(count);
+    if (threads > 1) {
+        /* even ranges keep both lanes of the x2 kernel busy */
+        size_t range = ((count / threads) + 1) & ~(size_t)1;
+        size_t offset = 0;
+        std::vector<std::thread> workers;
+        workers.reserve(threads - 1);
+        try {
+            while (workers.size() + 1 < threads && offset + range < count) {
+                workers.emplace_back(hashBlocks, input + offset * length, range, length, rate, chain.BytePtr() + offset * chain_size, chain_size);
+                offset += range;
+            }
+        } catch (...) {
+            /* failed to start another thread: the remaining blocks are hashed by this one */
+        }
+        hashBlocks(input + offset * length, count - offset, length, rate, chain.BytePtr() + offset * chain_size, chain_size);
+        for (std::thread& t : workers) {
+            t.join();
+        }
+    } else {
+        hashBlocks(input, count, length, rate, chain.BytePtr(), chain_size);
+    }
+    Keccak_HashUpdate(&outer, chain.BytePtr(), (DataLength)count * chain_size * 8);
+    block_count += count;
+}
+
+void nppcrypt::ParallelHash::Update(const byte* input, size_t length)
+{
+    while (length) {
+        if (buffered == 0 && length >= buffer.size()) {
+            size_t count = length / blocksize;
+            absorbBlocks(input, count, blocksize);
+            input += count * blocksize;
+            length -= count * blocksize;
+            continue;
+        }
+        size_t n = std::min(length, buffer.size() - buffered);
+        std::memcpy(buffer.BytePtr() + buffered, input, n);
+        buffered += n;
+        input += n;
+        length -= n;
+        if (buffered == buffer.size()) {
+            absorbBlocks(buffer.BytePtr(), Constants::parallelhash_batch, blocksize);
+            buffered = 0;
+        }
+    }
+}
+
+void nppcrypt::ParallelHash::TruncatedFinal(byte* hash, size_t size)
+{
+    ThrowIfInvalidTruncatedSize(size);
+
+    byte enc[9];
+    size_t count = buffered / blocksize;
+    size_t rest = buffered % blocksize;
+    if (count) {
+        absorbBlocks(buffer.BytePtr(), count, blocksize);
+    }
+    if (rest) {
+        absorbBlocks(buffer.BytePtr() + count * blocksize, 1, rest);
+    }
+    /* right_encode(n) || right_encode(L) */
+    size_t len = encode(block_count, enc, false);
+    Keccak_HashUpdate(&outer, enc, len * 8);
+    len = encode((unsigned long long)size * 8, enc, false);
+    Keccak_HashUpdate(&outer, enc, len * 8);
+    Keccak_HashFinal(&outer, hash);
+    Keccak_HashSqueeze(&outer, hash, (DataLength)size * 8);
+
+    Restart();
+}
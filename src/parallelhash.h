@@ -0,0 +1,62 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef PARALLELHASH_H_DEF
+#define PARALLELHASH_H_DEF
+
+#include <vector>
+#include "crypt.h"
+#include "cryptopp/cryptlib.h"
+#include "keccak/KeccakHash.h"
+
+namespace nppcrypt
+{
+    /* NIST SP 800-185 ParallelHash128/256: input is split into blocks of B bytes, every block is hashed on its own
+       (two blocks at once with KeccakF1600x2 if SSSE3 is available, large batches are spread over worker threads),
+       the chaining values are fed into cSHAKE with function name "ParallelHash" and customization string S. */
+    class ParallelHash : public CryptoPP::HashTransformation
+    {
+    public:
+        ParallelHash(unsigned int security, unsigned int digest, const byte* custom = NULL, size_t custom_len = 0, size_t block = Constants::parallelhash_blocksize);
+
+        std::string  AlgorithmName() const;
+        unsigned int DigestSize() const { return digest_size; };
+        unsigned int OptimalBlockSize() const { return (unsigned int)blocksize; };
+        void         Update(const byte* input, size_t length);
+        void         TruncatedFinal(byte* hash, size_t size);
+        void         Restart();
+
+        /* outer is ALIGN(32): the global operator new only guarantees 16 bytes before C++17 */
+        static void* operator new(size_t size);
+        static void  operator delete(void* p);
+
+    private:
+        void         absorbBlocks(const byte* input, size_t count, size_t length);
+
+        unsigned int                strength;
+        unsigned int                digest_size;
+        size_t                      blocksize;
+        size_t                      rate;
+        size_t                      chain_size;
+        unsigned long long          block_count;
+        std::vector<byte>           customization;
+        CryptoPP::SecByteBlock      buffer;
+        size_t                      buffered;
+        CryptoPP::SecByteBlock      chain;
+        Keccak_HashInstance         outer;
+    };
+};
+
+#endif
@@ -0,0 +1,504 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#include <cstring>
+#include "xxh3.h"
+#include "cryptopp/misc.h"
+#include "cryptopp/cpu.h"
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+# include <emmintrin.h>
+#endif
+#if defined(_MSC_VER) && defined(_M_X64)
+# include <intrin.h>
+#endif
+
+using namespace nppcrypt;
+using CryptoPP::word32;
+using CryptoPP::word64;
+
+namespace
+{
+    const word32 PRIME32_1 = 0x9E3779B1U;
+    const word32 PRIME32_2 = 0x85EBCA77U;
+    const word32 PRIME32_3 = 0xC2B2AE3DU;
+    const word64 PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    const word64 PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    const word64 PRIME64_3 = 0x165667B19E3779F9ULL;
+    const word64 PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    const word64 PRIME64_5 = 0x27D4EB2F165667C5ULL;
+    const word64 PRIME_MX1 = 0x165667919E3779F9ULL;
+    const word64 PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+    const size_t STRIPE_LEN = 64;
+    const size_t SECRET_SIZE = 192;
+    const size_t SECRET_CONSUME_RATE = 8;
+    const size_t STRIPES_PER_BLOCK = (SECRET_SIZE - STRIPE_LEN) / SECRET_CONSUME_RATE;
+    const size_t SECRET_LASTACC_START = 7;
+    const size_t SECRET_MERGEACCS_START = 11;
+    const size_t SECRET_SIZE_MIN = 136;
+    const size_t MIDSIZE_MAX = 240;
+    const size_t MIDSIZE_STARTOFFSET = 3;
+    const size_t MIDSIZE_LASTOFFSET = 17;
+
+    CRYPTOPP_ALIGN_DATA(64) const byte secret[SECRET_SIZE] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+    };
+
+    struct Hash128
+    {
+        word64 low;
+        word64 high;
+    };
+
+    inline word32 read32(const byte* p)
+    {
+        return CryptoPP::GetWord<word32>(false, CryptoPP::LITTLE_ENDIAN_ORDER, p);
+    }
+
+    inline word64 read64(const byte* p)
+    {
+        return CryptoPP::GetWord<word64>(false, CryptoPP::LITTLE_ENDIAN_ORDER, p);
+    }
+
+    inline Hash128 mult64to128(word64 a, word64 b)
+    {
+        Hash128 r;
+#if defined(_MSC_VER) && defined(_M_X64)
+        r.low = _umul128(a, b, &r.high);
+#elif defined(__SIZEOF_INT128__)
+        unsigned __int128 p = (unsigned __int128)a * b;
+        r.low = (word64)p;
+        r.high = (word64)(p >> 64);
+#else
+        word64 lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+        word64 hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+        word64 lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+        word64 hi_hi = (a >> 32) * (b >> 32);
+        word64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+        r.high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+        r.low = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+#endif
+        return r;
+    }
+
+    inline word64 mul128fold64(word64 a, word64 b)
+    {
+        Hash128 r = mult64to128(a, b);
+        return r.low ^ r.high;
+    }
+
+    inline word64 xorshift64(word64 v, int shift)
+    {
+        return v ^ (v >> shift);
+    }
+
+    word64 avalanche(word64 h)
+    {
+        h = xorshift64(h, 37);
+        h *= PRIME_MX1;
+        return xorshift64(h, 32);
+    }
+
+    word64 avalanche64(word64 h)
+    {
+        h ^= h >> 33;
+        h *= PRIME64_2;
+        h ^= h >> 29;
+        h *= PRIME64_3;
+        h ^= h >> 32;
+        return h;
+    }
+
+    word64 rrmxmx(word64 h, word64 length)
+    {
+        h ^= CryptoPP::rotlConstant<49>(h) ^ CryptoPP::rotlConstant<24>(h);
+        h *= PRIME_MX2;
+        h ^= (h >> 35) + length;
+        h *= PRIME_MX2;
+        return xorshift64(h, 28);
+    }
+
+    inline word64 mix16B(const byte* in, const byte* sec)
+    {
+        return mul128fold64(read64(in) ^ read64(sec), read64(in + 8) ^ read64(sec + 8));
+    }
+
+    inline void mix32B(Hash128& acc, const byte* in1, const byte* in2, const byte* sec)
+    {
+        acc.low += mix16B(in1, sec);
+        acc.low ^= read64(in2) + read64(in2 + 8);
+        acc.high += mix16B(in2, sec + 16);
+        acc.high ^= read64(in1) + read64(in1 + 8);
+    }
+
+    // ----------------------------- short inputs ( <= 240 bytes ) ---------------------------------------------------------------------
+
+    word64 hash64Short(const byte* in, size_t length)
+    {
+        if (length <= 16) {
+            if (length > 8) {
+                word64 bitflip1 = read64(secret + 24) ^ read64(secret + 32);
+                word64 bitflip2 = read64(secret + 40) ^ read64(secret + 48);
+                word64 lo = read64(in) ^ bitflip1;
+                word64 hi = read64(in + length - 8) ^ bitflip2;
+                return avalanche(length + CryptoPP::ByteReverse(lo) + hi + mul128fold64(lo, hi));
+            } else if (length >= 4) {
+                word64 bitflip = read64(secret + 8) ^ read64(secret + 16);
+                word64 input64 = read32(in + length - 4) + ((word64)read32(in) << 32);
+                return rrmxmx(input64 ^ bitflip, length);
+            } else if (length) {
+                word32 combined = ((word32)in[0] << 16) | ((word32)in[length >> 1] << 24) | (word32)in[length - 1] | ((word32)length << 8);
+                word64 bitflip = read32(secret) ^ read32(secret + 4);
+                return avalanche64((word64)combined ^ bitflip);
+            }
+            return avalanche64(read64(secret + 56) ^ read64(secret + 64));
+        }
+        word64 acc = length * PRIME64_1;
+        if (length <= 128) {
+            if (length > 32) {
+                if (length > 64) {
+                    if (length > 96) {
+                        acc += mix16B(in + 48, secret + 96);
+                        acc += mix16B(in + length - 64, secret + 112);
+                    }
+                    acc += mix16B(in + 32, secret + 64);
+                    acc += mix16B(in + length - 48, secret + 80);
+                }
+                acc += mix16B(in + 16, secret + 32);
+                acc += mix16B(in + length - 32, secret + 48);
+            }
+            acc += mix16B(in, secret);
+            acc += mix16B(in + length - 16, secret + 16);
+            return avalanche(acc);
+        }
+        for (size_t i = 0; i < 8; i++) {
+            acc += mix16B(in + 16 * i, secret + 16 * i);
+        }
+        acc = avalanche(acc);
+        for (size_t i = 8; i < length / 16; i++) {
+            acc += mix16B(in + 16 * i, secret + 16 * (i - 8) + MIDSIZE_STARTOFFSET);
+        }
+        acc += mix16B(in + length - 16, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET);
+        return avalanche(acc);
+    }
+
+    Hash128 hash128Short(const byte* in, size_t length)
+    {
+        Hash128 h;
+        if (length <= 16) {
+            if (length > 8) {
+                word64 bitflipl = read64(secret + 32) ^ read64(secret + 40);
+                word64 bitfliph = read64(secret + 48) ^ read64(secret + 56);
+                word64 lo = read64(in);
+                word64 hi = read64(in + length - 8);
+                Hash128 m = mult64to128(lo ^ hi ^ bitflipl, PRIME64_1);
+                m.low += (word64)(length - 1) << 54;
+                hi ^= bitfliph;
+                m.high += hi + (word64)(word32)hi * (PRIME32_2 - 1);
+                m.low ^= CryptoPP::ByteReverse(m.high);
+                h = mult64to128(m.low, PRIME64_2);
+                h.high += m.high * PRIME64_2;
+                h.low = avalanche(h.low);
+                h.high = avalanche(h.high);
+            } else if (length >= 4) {
+                word64 input64 = read32(in) + ((word64)read32(in + length - 4) << 32);
+                word64 bitflip = read64(secret + 16) ^ read64(secret + 24);
+                h = mult64to128(input64 ^ bitflip, PRIME64_1 + (length << 2));
+                h.high += h.low << 1;
+                h.low ^= h.high >> 3;
+                h.low = xorshift64(h.low, 35);
+                h.low *= PRIME_MX2;
+                h.low = xorshift64(h.low, 28);
+                h.high = avalanche(h.high);
+            } else if (length) {
+                word32 combinedl = ((word32)in[0] << 16) | ((word32)in[length >> 1] << 24) | (word32)in[length - 1] | ((word32)length << 8);
+                word32 combinedh = CryptoPP::rotlConstant<13>(CryptoPP::ByteReverse(combinedl));
+                h.low = avalanche64((word64)combinedl ^ (word64)(read32(secret) ^ read32(secret + 4)));
+                h.high = avalanche64((word64)combinedh ^ (word64)(read32(secret + 8) ^ read32(secret + 12)));
+            } else {
+                h.low = avalanche64(read64(secret + 64) ^ read64(secret + 72));
+                h.high = avalanche64(read64(secret + 80) ^ read64(secret + 88));
+            }
+            return h;
+        }
+        Hash128 acc;
+        acc.low = length * PRIME64_1;
+        acc.high = 0;
+        if (length <= 128) {
+            if (length > 32) {
+                if (length > 64) {
+                    if (length > 96) {
+                        mix32B(acc, in + 48, in + length - 64, secret + 96);
+                    }
+                    mix32B(acc, in + 32, in + length - 48, secret + 64);
+                }
+                mix32B(acc, in + 16, in + length - 32, secret + 32);
+            }
+            mix32B(acc, in, in + length - 16, secret);
+        } else {
+            for (size_t i = 0; i < 4; i++) {
+                mix32B(acc, in + 32 * i, in + 32 * i + 16, secret + 32 * i);
+            }
+            acc.low = avalanche(acc.low);
+            acc.high = avalanche(acc.high);
+            for (size_t i = 4; i < length / 32; i++) {
+                mix32B(acc, in + 32 * i, in + 32 * i + 16, secret + MIDSIZE_STARTOFFSET + 32 * (i - 4));
+            }
+            mix32B(acc, in + length - 16, in + length - 32, secret + SECRET_SIZE_MIN - MIDSIZE_LASTOFFSET - 16);
+        }
+        h.low = acc.low + acc.high;
+        h.high = acc.low * PRIME64_1 + acc.high * PRIME64_4 + length * PRIME64_2;
+        h.low = avalanche(h.low);
+        h.high = 0 - avalanche(h.high);
+        return h;
+    }
+
+    // ----------------------------- long inputs: stripe accumulation ------------------------------------------------------------------
+
+    void accumulateScalar(word64* acc, const byte* in, const byte* sec, size_t stripes)
+    {
+        for (size_t s = 0; s < stripes; s++, in += STRIPE_LEN, sec += SECRET_CONSUME_RATE) {
+            for (size_t i = 0; i < 8; i++) {
+                word64 data_val = read64(in + 8 * i);
+                word64 data_key = data_val ^ read64(sec + 8 * i);
+                acc[i ^ 1] += data_val;
+                acc[i] += (word64)(word32)data_key * (data_key >> 32);
+            }
+        }
+    }
+
+    void scrambleScalar(word64* acc, const byte* sec)
+    {
+        for (size_t i = 0; i < 8; i++) {
+            word64 a = xorshift64(acc[i], 47) ^ read64(sec + 8 * i);
+            acc[i] = a * PRIME32_1;
+        }
+    }
+
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+    void accumulateSSE2(word64* acc, const byte* in, const byte* sec, size_t stripes)
+    {
+        __m128i a[4];
+        for (int i = 0; i < 4; i++) {
+            a[i] = _mm_loadu_si128((const __m128i*)acc + i);
+        }
+        for (size_t s = 0; s < stripes; s++, in += STRIPE_LEN, sec += SECRET_CONSUME_RATE) {
+            for (int i = 0; i < 4; i++) {
+                __m128i data_vec = _mm_loadu_si128((const __m128i*)in + i);
+                __m128i data_key = _mm_xor_si128(data_vec, _mm_loadu_si128((const __m128i*)sec + i));
+                __m128i product = _mm_mul_epu32(data_key, _mm_shuffle_epi32(data_key, _MM_SHUFFLE(0, 3, 0, 1)));
+                __m128i sum = _mm_add_epi64(a[i], _mm_shuffle_epi32(data_vec, _MM_SHUFFLE(1, 0, 3, 2)));
+                a[i] = _mm_add_epi64(product, sum);
+            }
+        }
+        for (int i = 0; i < 4; i++) {
+            _mm_storeu_si128((__m128i*)acc + i, a[i]);
+        }
+    }
+
+    void scrambleSSE2(word64* acc, const byte* sec)
+    {
+        const __m128i prime32 = _mm_set1_epi32((int)PRIME32_1);
+        for (int i = 0; i < 4; i++) {
+            __m128i a = _mm_loadu_si128((const __m128i*)acc + i);
+            a = _mm_xor_si128(a, _mm_srli_epi64(a, 47));
+            a = _mm_xor_si128(a, _mm_loadu_si128((const __m128i*)sec + i));
+            __m128i prod_lo = _mm_mul_epu32(a, prime32);
+            __m128i prod_hi = _mm_mul_epu32(_mm_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime32);
+            _mm_storeu_si128((__m128i*)acc + i, _mm_add_epi64(prod_lo, _mm_slli_epi64(prod_hi, 32)));
+        }
+    }
+#endif
+
+    typedef void(*AccumulateFunc)(word64*, const byte*, const byte*, size_t);
+    typedef void(*ScrambleFunc)(word64*, const byte*);
+
+    struct Kernels
+    {
+        Kernels() : accumulate(accumulateScalar), scramble(scrambleScalar)
+        {
+#if (CRYPTOPP_AVX2_AVAILABLE)
+            if (CryptoPP::HasAVX2()) {
+                accumulate = simd::xxh3_accumulate_avx2;
+                scramble = simd::xxh3_scramble_avx2;
+                return;
+            }
+#endif
+#if (CRYPTOPP_SSE2_INTRIN_AVAILABLE)
+            if (CryptoPP::HasSSE2()) {
+                accumulate = accumulateSSE2;
+                scramble = scrambleSSE2;
+            }
+#endif
+        }
+        AccumulateFunc  accumulate;
+        ScrambleFunc    scramble;
+    };
+
+    const Kernels& kernels()
+    {
+        static const Kernels k;
+        return k;
+    }
+
+    word64 mergeAccs(const word64* acc, const byte* sec, word64 start)
+    {
+        word64 result = start;
+        for (size_t i = 0; i < 4; i++) {
+            result += mul128fold64(acc[2 * i] ^ read64(sec + 16 * i), acc[2 * i + 1] ^ read64(sec + 16 * i + 8));
+        }
+        return avalanche(result);
+    }
+}
+
+nppcrypt::XXH3::XXH3(unsigned int digest) : digest_size((digest == 16) ? 16 : 8)
+{
+    Restart();
+}
+
+std::string nppcrypt::XXH3::AlgorithmName() const
+{
+    return (digest_size == 16) ? "XXH3-128" : "XXH3-64";
+}
+
+void nppcrypt::XXH3::Restart()
+{
+    acc[0] = PRIME32_3;
+    acc[1] = PRIME64_1;
+    acc[2] = PRIME64_2;
+    acc[3] = PRIME64_3;
+    acc[4] = PRIME64_4;
+    acc[5] = PRIME32_2;
+    acc[6] = PRIME64_5;
+    acc[7] = PRIME32_1;
+    total = 0;
+    stripes = 0;
+    buffered = 0;
+}
+
+/* accumulates stripes, the accumulators are scrambled at the end of every block of STRIPES_PER_BLOCK stripes */
+void nppcrypt::XXH3::consume(const byte* input, size_t count)
+{
+    const Kernels& k = kernels();
+    while (count) {
+        size_t n = STRIPES_PER_BLOCK - stripes;
+        if (n > count) {
+            n = count;
+        }
+        k.accumulate(acc, input, secret + stripes * SECRET_CONSUME_RATE, n);
+        stripes += n;
+        input += n * STRIPE_LEN;
+        count -= n;
+        if (stripes == STRIPES_PER_BLOCK) {
+            k.scramble(acc, secret + SECRET_SIZE - STRIPE_LEN);
+            stripes = 0;
+        }
+    }
+}
+
+/* a stripe is only consumed if more input follows: the last stripe of the message is accumulated with a different secret */
+void nppcrypt::XXH3::Update(const byte* input, size_t length)
+{
+    total += length;
+    if (length <= sizeof(buffer) - buffered) {
+        std::memcpy(buffer + buffered, input, length);
+        buffered += length;
+        return;
+    }
+    if (buffered) {
+        size_t fill = sizeof(buffer) - buffered;
+        std::memcpy(buffer + buffered, input, fill);
+        input += fill;
+        length -= fill;
+        consume(buffer, sizeof(buffer) / STRIPE_LEN);
+        std::memcpy(last, buffer + sizeof(buffer) - STRIPE_LEN, STRIPE_LEN);
+        buffered = 0;
+    }
+    if (length > sizeof(buffer)) {
+        size_t n = (length - 1) / STRIPE_LEN;
+        consume(input, n);
+        input += n * STRIPE_LEN;
+        length -= n * STRIPE_LEN;
+        std::memcpy(last, input - STRIPE_LEN, STRIPE_LEN);
+    }
+    std::memcpy(buffer, input, length);
+    buffered = length;
+}
+
+void nppcrypt::XXH3::TruncatedFinal(byte* hash, size_t size)
+{
+    ThrowIfInvalidTruncatedSize(size);
+
+    Hash128 h;
+    if (total <= MIDSIZE_MAX) {
+        if (digest_size == 16) {
+            h = hash128Short(buffer, buffered);
+        } else {
+            h.low = hash64Short(buffer, buffered);
+        }
+    } else {
+        word64 a[8];
+        std::memcpy(a, acc, sizeof(a));
+        size_t s = stripes;
+        const Kernels& k = kernels();
+
+        /* remaining full stripes of the buffer, then the last 64 bytes of the message */
+        size_t n = (buffered - 1) / STRIPE_LEN;
+        for (size_t i = 0; i < n; i++) {
+            k.accumulate(a, buffer + i * STRIPE_LEN, secret + s * SECRET_CONSUME_RATE, 1);
+            if (++s == STRIPES_PER_BLOCK) {
+                k.scramble(a, secret + SECRET_SIZE - STRIPE_LEN);
+                s = 0;
+            }
+        }
+        byte stripe[STRIPE_LEN];
+        const byte* p;
+        if (buffered >= STRIPE_LEN) {
+            p = buffer + buffered - STRIPE_LEN;
+        } else {
+            std::memcpy(stripe, last + buffered, STRIPE_LEN - buffered);
+            std::memcpy(stripe + STRIPE_LEN - buffered, buffer, buffered);
+            p = stripe;
+        }
+        k.accumulate(a, p, secret + SECRET_SIZE - STRIPE_LEN - SECRET_LASTACC_START, 1);
+
+        h.low = mergeAccs(a, secret + SECRET_MERGEACCS_START, total * PRIME64_1);
+        if (digest_size == 16) {
+            h.high = mergeAccs(a, secret + SECRET_SIZE - STRIPE_LEN - SECRET_MERGEACCS_START, ~(total * PRIME64_2));
+        }
+    }
+
+    byte digest[16];
+    if (digest_size == 16) {
+        CryptoPP::PutWord<word64>(false, CryptoPP::BIG_ENDIAN_ORDER, digest, h.high);
+        CryptoPP::PutWord<word64>(false, CryptoPP::BIG_ENDIAN_ORDER, digest + 8, h.low);
+    } else {
+        CryptoPP::PutWord<word64>(false, CryptoPP::BIG_ENDIAN_ORDER, digest, h.low);
+    }
+    std::memcpy(hash, digest, size);
+    Restart();
+}
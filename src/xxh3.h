@@ -0,0 +1,59 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+#ifndef XXH3_H_DEF
+#define XXH3_H_DEF
+
+#include "crypt.h"
+#include "cryptopp/cryptlib.h"
+
+namespace nppcrypt
+{
+    /* XXH3 64/128 bit (xxHash 0.8, seed 0, default secret), non-cryptographic.
+       Stripes of long inputs are accumulated with AVX2 or SSE2 if available (see xxh3_avx2.cpp),
+       the digest is the canonical (big endian) representation. */
+    class XXH3 : public CryptoPP::HashTransformation
+    {
+    public:
+        XXH3(unsigned int digest = 8);
+
+        std::string  AlgorithmName() const;
+        unsigned int DigestSize() const { return digest_size; };
+        unsigned int OptimalBlockSize() const { return 1024; };
+        void         Update(const byte* input, size_t length);
+        void         TruncatedFinal(byte* hash, size_t size);
+        void         Restart();
+
+    private:
+        void         consume(const byte* input, size_t stripes);
+
+        unsigned int                digest_size;
+        CryptoPP::word64            acc[8];
+        unsigned long long          total;
+        size_t                      stripes;
+        size_t                      buffered;
+        byte                        buffer[256];
+        byte                        last[64];
+    };
+
+    namespace simd
+    {
+        /* stripes of 64 bytes, the secret advances 8 bytes per stripe */
+        void xxh3_accumulate_avx2(CryptoPP::word64* acc, const byte* input, const byte* secret, size_t stripes);
+        void xxh3_scramble_avx2(CryptoPP::word64* acc, const byte* secret);
+    };
+};
+
+#endif
@@ -0,0 +1,73 @@
+/*
+This file is part of nppcrypt
+(http://www.github.com/jeanpaulrichter/nppcrypt)
+
+This program is free software; you can redistribute it and/or
+modify it under the terms of the GNU General Public License
+as published by the Free Software Foundation; either version 2
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+*/
+
+/* AVX2 XXH3 stripe kernels, needs -mavx2 with gcc/clang (see GNUmakefile) */
+
+#include "xxh3.h"
+#include "cryptopp/config.h"
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+# include <immintrin.h>
+#endif
+
+using CryptoPP::word64;
+
+namespace nppcrypt
+{
+namespace simd
+{
+
+#if (CRYPTOPP_AVX2_AVAILABLE)
+/* acc[i ^ 1] += data[i], acc[i] += lo32(data[i] ^ key[i]) * hi32(data[i] ^ key[i]) */
+void xxh3_accumulate_avx2(word64* acc, const byte* input, const byte* secret, size_t stripes)
+{
+    __m256i a0 = _mm256_loadu_si256((const __m256i*)acc);
+    __m256i a1 = _mm256_loadu_si256((const __m256i*)acc + 1);
+
+    for (; stripes; stripes--, input += 64, secret += 8) {
+        __m256i d0 = _mm256_loadu_si256((const __m256i*)input);
+        __m256i d1 = _mm256_loadu_si256((const __m256i*)input + 1);
+        __m256i k0 = _mm256_xor_si256(d0, _mm256_loadu_si256((const __m256i*)secret));
+        __m256i k1 = _mm256_xor_si256(d1, _mm256_loadu_si256((const __m256i*)secret + 1));
+        __m256i p0 = _mm256_mul_epu32(k0, _mm256_shuffle_epi32(k0, _MM_SHUFFLE(0, 3, 0, 1)));
+        __m256i p1 = _mm256_mul_epu32(k1, _mm256_shuffle_epi32(k1, _MM_SHUFFLE(0, 3, 0, 1)));
+        a0 = _mm256_add_epi64(a0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2)));
+        a1 = _mm256_add_epi64(a1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2)));
+        a0 = _mm256_add_epi64(a0, p0);
+        a1 = _mm256_add_epi64(a1, p1);
+    }
+    _mm256_storeu_si256((__m256i*)acc, a0);
+    _mm256_storeu_si256((__m256i*)acc + 1, a1);
+    _mm256_zeroupper();
+}
+
+/* acc = (acc ^ (acc >> 47) ^ key) * PRIME32_1 */
+void xxh3_scramble_avx2(word64* acc, const byte* secret)
+{
+    const __m256i prime32 = _mm256_set1_epi32((int)0x9E3779B1U);
+    for (int i = 0; i < 2; i++) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)acc + i);
+        a = _mm256_xor_si256(a, _mm256_srli_epi64(a, 47));
+        a = _mm256_xor_si256(a, _mm256_loadu_si256((const __m256i*)secret + i));
+        __m256i prod_lo = _mm256_mul_epu32(a, prime32);
+        __m256i prod_hi = _mm256_mul_epu32(_mm256_shuffle_epi32(a, _MM_SHUFFLE(0, 3, 0, 1)), prime32);
+        _mm256_storeu_si256((__m256i*)acc + i, _mm256_add_epi64(prod_lo, _mm256_slli_epi64(prod_hi, 32)));
+    }
+    _mm256_zeroupper();
+}
+#endif
+
+};
+};